@@ -0,0 +1,325 @@
+
+#ifndef _MY_DICTIONARY_LOADER_H
+#define _MY_DICTIONARY_LOADER_H
+
+#include "FrozenTrie.h"
+#include "LoudsTrie.h"
+#include "QueryEngine.h"
+#include "Trie.h"
+#include "WordReader.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+using namespace std;
+
+struct LoadProgress {
+
+  // How far a dictionary build has got. The build is a series of
+  // steps, each given a weight of about its share of the time. The
+  // step that reads the file moves along with the bytes read; the
+  // others count once they are done. Setting cancelled (in file)
+  // stops the read at its next block, and the build checks it before
+  // each step. Safe to read from another thread during the build.
+
+  ReadProgress file;
+  atomic<int> doneWeight;  // steps finished
+  atomic<int> stepWeight;  // the step under way
+  atomic<int> totalWeight; // all of them
+  atomic<bool> reading;    // the step under way reads the file
+
+  LoadProgress()
+      : doneWeight(0), stepWeight(0), totalWeight(0), reading(false) {}
+
+  bool cancelled() const { return file.cancelled; }
+
+  /*
+   * function: step
+   * description: finishes the step under way and starts the next.
+   *
+   * parameter: int weight - share of the build the new step takes
+   *            bool readsFile - progress comes from file as it is read
+   *
+   * return:  indicates success/failure (the build was cancelled and
+   *   should stop)
+   */
+  bool step(int weight, bool readsFile = false) {
+    doneWeight += stepWeight;
+    reading = false;
+    stepWeight = weight;
+    reading = readsFile;
+    return !cancelled();
+  }
+
+  int percent() const {
+    int total = totalWeight;
+    if (total == 0) {
+      return 0;
+    }
+    long done = doneWeight * 100L;
+    if (reading) {
+      done += (long)stepWeight * file.percent();
+    }
+    return (int)(done / total);
+  }
+};
+
+class DictionaryLoader {
+
+  // Builds the next dictionary on a background thread while the game
+  // keeps playing against the one it has.
+  //
+  // start() queues a build function, which reads the file (reporting
+  // through progress) into the dictionary it is given and says if that
+  // worked. The game checks ready() between commands and take()s the
+  // result, so every command runs against either the old dictionary or
+  // the new one, never a half built one. A failed build is freed here
+  // and take() reports it, so the game keeps the dictionary it has.
+  //
+  // The same thread frees the dictionaries handed to retire(), so the
+  // game never waits on a free. Jobs run one at a time in the order
+  // given.
+  //
+  // Nothing waits long on a load that nobody will take: the destructor
+  // cancels it, and the build stops at its next step or block of the
+  // file. abandon() is for process exit: the worker is not waited for
+  // at all and what it holds is left to the OS. Everything the worker
+  // uses is kept in a State of its own so that it can outlive the
+  // loader.
+
+public:
+  //   one complete dictionary; whoever holds it owns the pointers
+  struct Dictionary {
+    Trie *editable;
+    FrozenTrie *frozen;
+    LoudsTrie *compact;
+    QueryEngine *engine;
+    Dictionary()
+        : editable(nullptr), frozen(nullptr), compact(nullptr),
+          engine(nullptr) {}
+  };
+  typedef function<bool(Dictionary &, LoadProgress *)> BuildFunction;
+  enum Outcome { NONE, LOADED, FAILED };
+
+protected:
+  struct State {
+    deque<function<void()>> jobs;
+    bool stopping;
+    bool loading; // a load was started and not taken yet
+    bool loaded;  // its result is waiting in result
+    bool loadOk;  // and the build worked
+    atomic<bool> abandoned; // exiting, memory is left to the OS
+    Dictionary result;
+    string loadName;
+    LoadProgress progress;
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    State()
+        : stopping(false), loading(false), loaded(false), loadOk(false),
+          abandoned(false) {}
+  };
+
+  //   data members
+  State *state;
+  thread worker;
+
+  static void work(State *state) {
+    unique_lock<mutex> guard(state->lock);
+    while (true) {
+      state->wake.wait(guard, [state] {
+        return state->stopping || !state->jobs.empty();
+      });
+      if (state->jobs.empty()) {
+        return;
+      }
+      function<void()> job = move(state->jobs.front());
+      state->jobs.pop_front();
+      guard.unlock();
+      job();
+      guard.lock();
+    }
+  }
+
+  void push(function<void()> job) {
+    lock_guard<mutex> guard(state->lock);
+    if (!worker.joinable()) {
+      worker = thread(&DictionaryLoader::work, state);
+    }
+    state->jobs.push_back(move(job));
+    state->wake.notify_one();
+  }
+
+  static void destroy(Dictionary &dict) {
+    delete dict.editable;
+    delete dict.frozen;
+    delete dict.compact;
+    delete dict.engine;
+    dict = Dictionary();
+  }
+
+public:
+  /**
+   * constructor and destructor
+   */
+  DictionaryLoader() : state(new State()) {}
+  ~DictionaryLoader() {
+    {
+      lock_guard<mutex> guard(state->lock);
+      state->stopping = true;
+      state->progress.file.cancelled = true;
+      state->wake.notify_one();
+    }
+    if (state->abandoned) {
+      // the worker may be in a step that cannot stop; it finishes on
+      // its own and the state stays for it
+      if (worker.joinable()) {
+        worker.detach();
+      }
+      return;
+    }
+    // the queued jobs are finished first, a load stops early
+    if (worker.joinable()) {
+      worker.join();
+    }
+    destroy(state->result);
+    delete state;
+  }
+
+  /*
+   * function: abandon
+   * description:  for a process about to exit: cancels the load,
+   *   drops the queued jobs and leaves the dictionaries they would
+   *   have freed (and whatever the load built) for the OS to reclaim.
+   *   The destructor then returns without waiting for the worker.
+   *
+   * return:  nothing
+   */
+  void abandon() {
+    lock_guard<mutex> guard(state->lock);
+    state->abandoned = true;
+    state->progress.file.cancelled = true;
+    state->jobs.clear();
+  }
+
+  bool abandoned() const { return state->abandoned; }
+
+  /*
+   * function: start
+   * description:  queues a load of the dictionary called name.
+   *
+   * parameter: string name - shown while loading (the file name)
+   *            BuildFunction build - makes the new dictionary
+   *
+   * return:  indicates success/failure (another load is not taken yet)
+   */
+  bool start(const string &name, BuildFunction build) {
+    {
+      lock_guard<mutex> guard(state->lock);
+      if (state->loading) {
+        return false;
+      }
+      state->loading = true;
+      state->loadName = name;
+      LoadProgress &progress = state->progress;
+      progress.file.done = 0;
+      progress.file.total = 0;
+      progress.doneWeight = 0;
+      progress.stepWeight = 0;
+      progress.totalWeight = 0;
+      progress.reading = false;
+    }
+    State *shared = state;
+    push([shared, build]() {
+      Dictionary next;
+      // a load queued behind other jobs may be cancelled already
+      bool ok = !shared->progress.cancelled() &&
+                build(next, &shared->progress);
+      if (!ok) {
+        if (!shared->abandoned) {
+          destroy(next);
+        }
+        next = Dictionary();
+      }
+      lock_guard<mutex> guard(shared->lock);
+      shared->result = next;
+      shared->loaded = true;
+      shared->loadOk = ok;
+      shared->finished.notify_all();
+    });
+    return true;
+  }
+
+  /*
+   * function: busy / ready / percent / name
+   * description:  state of the load: started and not taken, finished
+   *   and waiting to be taken, how much of it is done, and what is
+   *   being loaded.
+   */
+  bool busy() {
+    lock_guard<mutex> guard(state->lock);
+    return state->loading;
+  }
+
+  bool ready() {
+    lock_guard<mutex> guard(state->lock);
+    return state->loaded;
+  }
+
+  int percent() {
+    lock_guard<mutex> guard(state->lock);
+    if (state->loaded) {
+      return 100;
+    }
+    int done = state->progress.percent();
+    return done < 99 ? done : 99;
+  }
+
+  string name() {
+    lock_guard<mutex> guard(state->lock);
+    return state->loadName;
+  }
+
+  /*
+   * function: take
+   * description:  hands over the finished dictionary, waiting for it
+   *   first if asked to. Either way the load is over once it has
+   *   been taken.
+   *
+   * parameter: Dictionary next - set to the new dictionary
+   *            bool wait - wait for a load still running
+   *
+   * return:  LOADED when next is set, FAILED when the build failed
+   *   (next is left empty), NONE when no load has finished
+   */
+  Outcome take(Dictionary &next, bool wait) {
+    unique_lock<mutex> guard(state->lock);
+    if (wait && state->loading) {
+      state->finished.wait(guard, [this] { return state->loaded; });
+    }
+    if (!state->loaded) {
+      return NONE;
+    }
+    next = state->result;
+    state->result = Dictionary();
+    state->loaded = false;
+    state->loading = false;
+    return state->loadOk ? LOADED : FAILED;
+  }
+
+  /*
+   * function: retire
+   * description:  frees a dictionary that is no longer in use on the
+   *   background thread.
+   *
+   * return:  nothing
+   */
+  void retire(Dictionary old) {
+    push([old]() mutable { destroy(old); });
+  }
+};
+
+#endif
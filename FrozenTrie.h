@@ -0,0 +1,234 @@
+
+#ifndef _MY_FROZEN_TRIE_H
+#define _MY_FROZEN_TRIE_H
+
+#include "Trie.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+class FrozenTrie {
+
+  // A read-only copy of a Trie packed into one array. Each node is 8
+  // bytes: a bit mask of the letters it has children for (plus the
+  // word flag) and the index of its first child. The children of a
+  // node sit next to each other in letter order, so the child for a
+  // letter is firstChild + the number of mask bits below it.
+  //
+  // The top levels are laid out breadth first, so the nodes every
+  // search goes through share a few cache lines. Below that each
+  // subtree is laid out depth first, so finishing a word (or walking
+  // a subtree for sbWords) stays in one region of the array.
+
+protected:
+  //   definition of frozen node structure
+  struct FrozenNode {
+    uint32_t mask; // bits 0-25 letters 'a'-'z', bit 31 end of a word
+    uint32_t firstChild;
+  };
+  static const uint32_t IS_WORD_BIT = 1u << 31;
+  static const uint32_t LETTER_BITS = (1u << 26) - 1;
+  // levels laid out breadth first before switching to depth first
+  static const int BFS_LEVELS = 3;
+  //   data members
+  vector<FrozenNode> nodes;
+  int wordCounter;
+
+  /*
+   * function: addChildren
+   * description: reserves a block for the children of the trie node
+   *    and fills in the mask and first child of the frozen node.
+   *
+   * return:  nothing
+   */
+  void addChildren(Trie::TrieNode *source, uint32_t index) {
+    uint32_t mask = source->isWord ? IS_WORD_BIT : 0;
+    for (int i = 0; i < 26; i++) {
+      if (source->letters[i] != nullptr) {
+        mask |= 1u << i;
+      }
+    }
+    nodes[index].mask = mask;
+    nodes[index].firstChild = nodes.size();
+    nodes.resize(nodes.size() + __builtin_popcount(mask & LETTER_BITS));
+  }
+
+  /*
+   * function: depthFirstLayout
+   * description: places the children of the node as one block, then
+   *    does the same for each child in turn.
+   *
+   * return:  nothing
+   */
+  void depthFirstLayout(Trie::TrieNode *source, uint32_t index) {
+    addChildren(source, index);
+    uint32_t next = nodes[index].firstChild;
+    for (int i = 0; i < 26; i++) {
+      if (source->letters[i] != nullptr) {
+        depthFirstLayout(source->letters[i], next++);
+      }
+    }
+  }
+
+  void wordsHelper(uint32_t node, vector<string> *trieWords,
+                   string &prevChars) const {
+    for (int i = 0; i < 26; i++) {
+      uint32_t next = child(node, i);
+      if (next != npos) {
+        prevChars.push_back('a' + i);
+        if (isWord(next)) {
+          trieWords->push_back(prevChars);
+        }
+        wordsHelper(next, trieWords, prevChars);
+        prevChars.pop_back();
+      }
+    }
+  }
+
+public:
+  static const uint32_t npos = 0xFFFFFFFF;
+
+  /**
+   * constructor
+   */
+  FrozenTrie() { clear(); }
+  FrozenTrie(const Trie &trie) { build(trie); }
+
+  /*
+   * function: build
+   * description:  replaces the contents with a packed copy of the
+   *   trie given by the parameter.
+   *
+   * return:  nothing
+   */
+  void build(const Trie &trie) {
+    nodes.assign(1, FrozenNode());
+    wordCounter = trie.wordCount();
+    // breadth first for the top levels, remembering where it stopped
+    vector<pair<Trie::TrieNode *, uint32_t>> level;
+    level.push_back(make_pair(trie.root, 0));
+    for (int depth = 0; depth < BFS_LEVELS && !level.empty(); depth++) {
+      vector<pair<Trie::TrieNode *, uint32_t>> nextLevel;
+      for (auto &entry : level) {
+        addChildren(entry.first, entry.second);
+        uint32_t next = nodes[entry.second].firstChild;
+        for (int i = 0; i < 26; i++) {
+          if (entry.first->letters[i] != nullptr) {
+            nextLevel.push_back(make_pair(entry.first->letters[i], next++));
+          }
+        }
+      }
+      level.swap(nextLevel);
+    }
+    // depth first below that
+    for (auto &entry : level) {
+      depthFirstLayout(entry.first, entry.second);
+    }
+    nodes.shrink_to_fit();
+  }
+
+  /*
+   * function: clear
+   * description:  leaves just an empty root and gives the node array
+   *   back to the allocator.
+   *
+   * return:  nothing
+   */
+  void clear() {
+    vector<FrozenNode>(1).swap(nodes);
+    nodes[0].mask = 0;
+    nodes[0].firstChild = 1;
+    wordCounter = 0;
+  }
+
+  /*
+   * function: root / child / nthChild / isWord / childCount
+   * description:  node access for walking the trie. Nodes are
+   *   indexes; child returns npos when there is no child for the
+   *   letter (0-25). nthChild returns child number n (0 up to
+   *   childCount - 1, in letter order) and sets its letter.
+   */
+  uint32_t root() const { return 0; }
+
+  uint32_t child(uint32_t node, int letter) const {
+    uint32_t mask = nodes[node].mask;
+    uint32_t bit = 1u << letter;
+    if (!(mask & bit)) {
+      return npos;
+    }
+    return nodes[node].firstChild + __builtin_popcount(mask & (bit - 1));
+  }
+
+  uint32_t nthChild(uint32_t node, int n, int &letter) const {
+    uint32_t mask = nodes[node].mask & LETTER_BITS;
+    for (int i = 0; i < n; i++) {
+      mask &= mask - 1;
+    }
+    letter = __builtin_ctz(mask);
+    return nodes[node].firstChild + n;
+  }
+
+  bool isWord(uint32_t node) const { return nodes[node].mask & IS_WORD_BIT; }
+
+  int childCount(uint32_t node) const {
+    return __builtin_popcount(nodes[node].mask & LETTER_BITS);
+  }
+
+  /*
+   * function: search
+   * description:  determines if the word given by the parameter
+   *   is stored in the trie.
+   *
+   * return:  indicates success/failure
+   */
+  bool search(const string &word) const {
+    uint32_t node = root();
+    for (auto character : word) {
+      if (character < 'a' || character > 'z') {
+        return false;
+      }
+      node = child(node, character - 'a');
+      if (node == npos) {
+        return false;
+      }
+    }
+    return isWord(node);
+  }
+
+  /*
+   * function: words
+   * description:  build a vector of all words in sorted ascending
+   *   order.
+   *
+   * return:  a pointer to a vector of strings
+   */
+  vector<string> *words() const {
+    vector<string> *trieWords = new vector<string>();
+    string prevChars;
+    wordsHelper(root(), trieWords, prevChars);
+    return trieWords;
+  }
+
+  int wordCount() const { return wordCounter; }
+
+  /*
+   * function: stats
+   * description:  counts nodes, bytes, fan-out and depth (see
+   *   TrieStats).
+   *
+   * return:  the stats
+   */
+  TrieStats stats() const {
+    TrieStats trieStats;
+    trieStats.walk(*this, root(), 0);
+    trieStats.bytes = memoryBytes();
+    return trieStats;
+  }
+
+  size_t nodeCount() const { return nodes.size(); }
+
+  size_t memoryBytes() const { return nodes.capacity() * sizeof(FrozenNode); }
+};
+
+#endif
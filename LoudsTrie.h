@@ -0,0 +1,350 @@
+
+#ifndef _MY_LOUDS_TRIE_H
+#define _MY_LOUDS_TRIE_H
+
+#include "FrozenTrie.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+class BitVector {
+
+  // A plain bit array with rank (count the 1s before a position) and
+  // select (find the k-th 0) support. A running count of 1s is kept
+  // every 512 bits, which adds 1/16 to the size.
+
+protected:
+  //   data members
+  vector<uint64_t> bitWords;
+  vector<uint32_t> blockRanks; // 1s before each 512 bit block
+  size_t bitCount;
+  static const int WORDS_PER_BLOCK = 8;
+
+  size_t zerosBeforeBlock(size_t block) const {
+    return block * 64 * WORDS_PER_BLOCK - blockRanks[block];
+  }
+
+public:
+  BitVector() : bitCount(0) {}
+
+  void push(bool bit) {
+    if (bitCount % 64 == 0) {
+      bitWords.push_back(0);
+    }
+    if (bit) {
+      bitWords.back() |= 1ull << (bitCount % 64);
+    }
+    bitCount++;
+  }
+
+  bool get(size_t pos) const { return (bitWords[pos / 64] >> (pos % 64)) & 1; }
+
+  size_t size() const { return bitCount; }
+
+  /*
+   * function: finish
+   * description: builds the rank blocks. Call once after the last
+   *   push and before rank or select.
+   *
+   * return:  nothing
+   */
+  void finish() {
+    bitWords.shrink_to_fit();
+    blockRanks.clear();
+    uint32_t ones = 0;
+    for (size_t i = 0; i < bitWords.size(); i++) {
+      if (i % WORDS_PER_BLOCK == 0) {
+        blockRanks.push_back(ones);
+      }
+      ones += __builtin_popcountll(bitWords[i]);
+    }
+    // sentinel so every block has an end
+    blockRanks.push_back(ones);
+    blockRanks.shrink_to_fit();
+  }
+
+  /*
+   * function: rank1
+   * description: counts the 1 bits in positions [0, pos).
+   *
+   * return:  the number of 1 bits
+   */
+  size_t rank1(size_t pos) const {
+    size_t word = pos / 64;
+    size_t block = word / WORDS_PER_BLOCK;
+    size_t ones = blockRanks[block];
+    for (size_t i = block * WORDS_PER_BLOCK; i < word; i++) {
+      ones += __builtin_popcountll(bitWords[i]);
+    }
+    if (pos % 64) {
+      ones += __builtin_popcountll(bitWords[word] << (64 - pos % 64));
+    }
+    return ones;
+  }
+
+  /*
+   * function: select0
+   * description: finds the position of the k-th 0 bit (k from 1).
+   *   Binary search over the blocks, then a scan of one block.
+   *
+   * return:  the position of the bit
+   */
+  size_t select0(size_t k) const {
+    size_t low = 0;
+    size_t high = blockRanks.size() - 1;
+    // last block with fewer than k zeros before it
+    while (high - low > 1) {
+      size_t mid = (low + high) / 2;
+      if (zerosBeforeBlock(mid) < k) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    size_t remaining = k - zerosBeforeBlock(low);
+    size_t word = low * WORDS_PER_BLOCK;
+    while (true) {
+      size_t zeros = 64 - __builtin_popcountll(bitWords[word]);
+      if (zeros >= remaining) {
+        break;
+      }
+      remaining -= zeros;
+      word++;
+    }
+    uint64_t inverted = ~bitWords[word];
+    for (size_t i = 1; i < remaining; i++) {
+      inverted &= inverted - 1;
+    }
+    return word * 64 + __builtin_ctzll(inverted);
+  }
+
+  /*
+   * function: runOfOnes
+   * description: counts the 1 bits starting at pos up to the next 0.
+   *
+   * return:  the length of the run
+   */
+  size_t runOfOnes(size_t pos) const {
+    size_t length = 0;
+    while (true) {
+      size_t offset = pos % 64;
+      // set where the bits from pos on are 0
+      uint64_t zeros = ~bitWords[pos / 64] >> offset;
+      if (zeros != 0) {
+        return length + __builtin_ctzll(zeros);
+      }
+      length += 64 - offset;
+      pos += 64 - offset;
+    }
+  }
+
+  size_t memoryBytes() const {
+    return bitWords.capacity() * sizeof(uint64_t) +
+           blockRanks.capacity() * sizeof(uint32_t);
+  }
+};
+
+class LoudsTrie {
+
+  // A read-only, succinct copy of a dictionary (LOUDS: level-order
+  // unary degree sequence). Nodes are numbered in breadth first order
+  // with the root as 0. Going through the nodes in that order, each
+  // one writes a 1 bit per child followed by a 0. The children of a
+  // node are then found with select/rank on that bit string.
+  // Alongside it are the 5-bit letter of every node and one word bit
+  // per node, which comes to about 8.2 bits per node in all.
+  //
+  // Offers the same node walking calls as FrozenTrie, so the Spelling
+  // Bee search works on either.
+
+protected:
+  //   data members
+  BitVector louds;
+  vector<uint64_t> labels; // 5 bits per node, root has none
+  BitVector wordBits;
+  size_t nodeTotal;
+  int wordCounter;
+  static const int LABEL_BITS = 5;
+
+  // stores the letter of node number nodeTotal
+  void pushLabel(int letter) {
+    size_t pos = (nodeTotal - 1) * LABEL_BITS;
+    if (pos / 64 + 1 >= labels.size()) {
+      labels.resize(pos / 64 + 2, 0);
+    }
+    labels[pos / 64] |= (uint64_t)letter << (pos % 64);
+    if (pos % 64 > 64 - LABEL_BITS) {
+      labels[pos / 64 + 1] |= (uint64_t)letter >> (64 - pos % 64);
+    }
+  }
+
+  int label(uint32_t node) const {
+    size_t pos = (size_t)(node - 1) * LABEL_BITS;
+    uint64_t bits = labels[pos / 64] >> (pos % 64);
+    if (pos % 64 > 64 - LABEL_BITS) {
+      bits |= labels[pos / 64 + 1] << (64 - pos % 64);
+    }
+    return bits & ((1 << LABEL_BITS) - 1);
+  }
+
+  // position of the first child bit of the node
+  size_t childStart(uint32_t node) const {
+    return node == 0 ? 0 : louds.select0(node) + 1;
+  }
+
+  void wordsHelper(uint32_t node, vector<string> *trieWords,
+                   string &prevChars) const {
+    size_t start = childStart(node);
+    size_t degree = louds.runOfOnes(start);
+    uint32_t first = louds.rank1(start) + 1;
+    for (uint32_t next = first; next < first + degree; next++) {
+      prevChars.push_back('a' + label(next));
+      if (isWord(next)) {
+        trieWords->push_back(prevChars);
+      }
+      wordsHelper(next, trieWords, prevChars);
+      prevChars.pop_back();
+    }
+  }
+
+public:
+  static const uint32_t npos = 0xFFFFFFFF;
+
+  /**
+   * constructor
+   */
+  LoudsTrie() { build(FrozenTrie()); }
+  LoudsTrie(const FrozenTrie &frozen) { build(frozen); }
+
+  /*
+   * function: build
+   * description:  replaces the contents with a succinct copy of the
+   *   frozen trie, visiting its nodes breadth first.
+   *
+   * return:  nothing
+   */
+  void build(const FrozenTrie &frozen) {
+    louds = BitVector();
+    wordBits = BitVector();
+    labels.clear();
+    nodeTotal = 1;
+    wordCounter = frozen.wordCount();
+    vector<uint32_t> queue(1, frozen.root());
+    wordBits.push(frozen.isWord(frozen.root()));
+    for (size_t head = 0; head < queue.size(); head++) {
+      for (int letter = 0; letter < 26; letter++) {
+        uint32_t next = frozen.child(queue[head], letter);
+        if (next != FrozenTrie::npos) {
+          louds.push(true);
+          pushLabel(letter);
+          nodeTotal++;
+          wordBits.push(frozen.isWord(next));
+          queue.push_back(next);
+        }
+      }
+      louds.push(false);
+    }
+    louds.finish();
+    wordBits.finish();
+    labels.shrink_to_fit();
+  }
+
+  /*
+   * function: root / child / nthChild / isWord / childCount
+   * description:  node access for walking the trie, same as
+   *   FrozenTrie. child returns npos when there is no child for the
+   *   letter (0-25). nthChild returns child number n (0 up to
+   *   childCount - 1, in letter order) and sets its letter.
+   */
+  uint32_t root() const { return 0; }
+
+  uint32_t child(uint32_t node, int letter) const {
+    size_t start = childStart(node);
+    size_t degree = louds.runOfOnes(start);
+    uint32_t first = louds.rank1(start) + 1;
+    // children are in letter order
+    for (uint32_t next = first; next < first + degree; next++) {
+      int nextLetter = label(next);
+      if (nextLetter == letter) {
+        return next;
+      }
+      if (nextLetter > letter) {
+        break;
+      }
+    }
+    return npos;
+  }
+
+  uint32_t nthChild(uint32_t node, int n, int &letter) const {
+    uint32_t next = louds.rank1(childStart(node)) + 1 + n;
+    letter = label(next);
+    return next;
+  }
+
+  bool isWord(uint32_t node) const { return wordBits.get(node); }
+
+  int childCount(uint32_t node) const {
+    return louds.runOfOnes(childStart(node));
+  }
+
+  /*
+   * function: search
+   * description:  determines if the word given by the parameter
+   *   is stored in the trie.
+   *
+   * return:  indicates success/failure
+   */
+  bool search(const string &word) const {
+    uint32_t node = root();
+    for (auto character : word) {
+      if (character < 'a' || character > 'z') {
+        return false;
+      }
+      node = child(node, character - 'a');
+      if (node == npos) {
+        return false;
+      }
+    }
+    return isWord(node);
+  }
+
+  /*
+   * function: words
+   * description:  build a vector of all words in sorted ascending
+   *   order.
+   *
+   * return:  a pointer to a vector of strings
+   */
+  vector<string> *words() const {
+    vector<string> *trieWords = new vector<string>();
+    string prevChars;
+    wordsHelper(root(), trieWords, prevChars);
+    return trieWords;
+  }
+
+  int wordCount() const { return wordCounter; }
+
+  /*
+   * function: stats
+   * description:  counts nodes, bytes, fan-out and depth (see
+   *   TrieStats).
+   *
+   * return:  the stats
+   */
+  TrieStats stats() const {
+    TrieStats trieStats;
+    trieStats.walk(*this, root(), 0);
+    trieStats.bytes = memoryBytes();
+    return trieStats;
+  }
+
+  size_t nodeCount() const { return nodeTotal; }
+
+  size_t memoryBytes() const {
+    return louds.memoryBytes() + wordBits.memoryBytes() +
+           labels.capacity() * sizeof(uint64_t);
+  }
+};
+
+#endif
@@ -0,0 +1,491 @@
+
+#ifndef _MY_QUERY_ENGINE_H
+#define _MY_QUERY_ENGINE_H
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct LetterQuery {
+
+  // Which dictionary words a game wants: built only from the allowed
+  // letters, using every required letter, between minLength and
+  // maxLength long. In exact mode the word must use exactly the
+  // letters in counts (an anagram).
+
+  uint32_t allowedMask;
+  uint32_t requiredMask;
+  size_t minLength;
+  size_t maxLength;
+  bool exact;
+  int counts[26];
+
+  LetterQuery()
+      : allowedMask((1u << 26) - 1), requiredMask(0), minLength(1),
+        maxLength(~(size_t)0), exact(false) {
+    for (int i = 0; i < 26; i++) {
+      counts[i] = 0;
+    }
+  }
+
+  static uint32_t maskOf(const string &letters) {
+    uint32_t mask = 0;
+    for (auto letter : letters) {
+      if (letter >= 'a' && letter <= 'z') {
+        mask |= 1u << (letter - 'a');
+      }
+    }
+    return mask;
+  }
+
+  /*
+   * function: spellingBee
+   * description: the standard game: the central letter plus the
+   *   other letters, the central letter required, at least 4 long.
+   *
+   * return:  the query
+   */
+  static LetterQuery spellingBee(char centralLetter, const string &letters) {
+    LetterQuery query;
+    query.requiredMask = maskOf(string(1, centralLetter));
+    query.allowedMask = maskOf(letters) | query.requiredMask;
+    query.minLength = 4;
+    return query;
+  }
+
+  /*
+   * function: anagramOf
+   * description: words using exactly the given letters, each as many
+   *   times as it appears.
+   *
+   * return:  the query
+   */
+  static LetterQuery anagramOf(const string &letters) {
+    LetterQuery query;
+    query.exact = true;
+    query.allowedMask = maskOf(letters);
+    query.requiredMask = query.allowedMask;
+    query.minLength = 0;
+    for (auto letter : letters) {
+      if (letter >= 'a' && letter <= 'z') {
+        query.counts[letter - 'a']++;
+        query.minLength++;
+      }
+    }
+    query.maxLength = query.minLength;
+    return query;
+  }
+
+  /*
+   * function: accepts
+   * description: the word-level checks left once every letter is
+   *   known to be allowed (and, in exact mode, not over its count).
+   *
+   * return:  indicates success/failure
+   */
+  bool accepts(size_t length, uint32_t seenMask) const {
+    return length >= minLength && length <= maxLength &&
+           (seenMask & requiredMask) == requiredMask;
+  }
+
+  /*
+   * function: matches
+   * description: checks a whole word against the query.
+   *
+   * return:  indicates success/failure
+   */
+  bool matches(const string &word) const {
+    int used[26] = {0};
+    uint32_t seen = 0;
+    for (auto letter : word) {
+      int index = letter - 'a';
+      if (index < 0 || index >= 26 || !(allowedMask & (1u << index))) {
+        return false;
+      }
+      seen |= 1u << index;
+      if (exact && ++used[index] > counts[index]) {
+        return false;
+      }
+    }
+    return accepts(word.length(), seen);
+  }
+};
+
+struct QueryResult {
+
+  // Output of QueryEngine::run: the words (sorted) and how they were
+  // found.
+
+  vector<string> words;
+  string plan;     // "walk" or "scan"
+  double walkCost; // estimated work for each plan
+  double scanCost;
+  double millis;   // time to run the chosen plan
+  size_t found;    // words matched, kept when words is cleared
+
+  QueryResult() : walkCost(0), scanCost(0), millis(0), found(0) {}
+
+  void print(ostream &out) const {
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << "plan: " << plan << " (estimated cost walk " << fixed
+        << setprecision(0) << walkCost << ", scan " << scanCost << "), "
+        << found << " words in " << setprecision(3) << millis
+        << " ms" << endl;
+    out.flags(flags);
+    out.precision(precision);
+  }
+};
+
+class QueryEngine {
+
+  // Runs a LetterQuery against a read-only dictionary (FrozenTrie or
+  // LoudsTrie) with one of two plans:
+  //
+  //   walk - descend the trie through allowed letters only. Its cost
+  //          grows with the number of nodes whose path uses only
+  //          allowed letters.
+  //   scan - go through a flat index of every word's letter mask and
+  //          length and keep the ones that fit. Its cost is about the
+  //          same for every query.
+  //
+  // The index holds no text, 7 bytes per word: the mask, the length,
+  // the number of letters shared with the word before (the words are
+  // in sorted order) and which child the word takes where it parts
+  // from the word before. Below that it takes the first child every
+  // time. That is enough to spell out the words that fit by going
+  // down the trie with nthChild; the rest are never spelled out.
+  //
+  // The first query (or prepare) builds the index from the sorted
+  // word list. The same pass counts the trie nodes per depth and per
+  // letter, which is what the walk estimate uses: at depth d, about
+  // nodes[d] * (share of nodes on allowed letters)^d are reached, and
+  // for an anagram no more than the orderings of d of its letters.
+  // The cheaper estimate wins.
+
+protected:
+  static const size_t MAX_INDEX_LENGTH = 255;
+  //   data members
+  bool prepared;
+  // the index, one entry per word in sorted order
+  vector<uint32_t> masks;
+  vector<uint8_t> lengths;
+  vector<uint8_t> shared; // letters in common with the word before
+  vector<uint8_t> branch; // child taken at depth shared
+  bool scannable;         // false if a word is too long for the index
+  vector<double> depthNodes; // trie nodes at each depth
+  double letterNodes[26];    // trie nodes reached by each letter
+  double totalNodes;
+  // relative cost of one child probe in the walk against checking
+  // one index entry in the scan
+  double probeCost;
+
+  template <typename Dict>
+  void walkHelper(const Dict &dict, const LetterQuery &query, uint32_t node,
+                  string &prefix, uint32_t seenMask, int *remaining,
+                  vector<string> *out) const {
+    if (prefix.length() >= query.maxLength) {
+      return;
+    }
+    for (int letter = 0; letter < 26; letter++) {
+      if (!(query.allowedMask & (1u << letter)) ||
+          (query.exact && remaining[letter] == 0)) {
+        continue;
+      }
+      uint32_t next = dict.child(node, letter);
+      if (next == Dict::npos) {
+        continue;
+      }
+      prefix.push_back('a' + letter);
+      remaining[letter]--;
+      uint32_t nextSeen = seenMask | (1u << letter);
+      if (dict.isWord(next) && query.accepts(prefix.length(), nextSeen)) {
+        out->push_back(prefix);
+      }
+      walkHelper(dict, query, next, prefix, nextSeen, remaining, out);
+      remaining[letter]++;
+      prefix.pop_back();
+    }
+  }
+
+  // prepare's walk below node. common and next are where the next
+  // word parts from the word before and the child it takes there.
+  template <typename Dict>
+  void indexHelper(const Dict &dict, uint32_t node, size_t depth,
+                   uint32_t mask, size_t &common, int &next) {
+    int children = dict.childCount(node);
+    if (children > 0 && depthNodes.size() <= depth + 1) {
+      depthNodes.resize(depth + 2, 0);
+    }
+    for (int n = 0; n < children; n++) {
+      int letter;
+      uint32_t child = dict.nthChild(node, n, letter);
+      if (depth < common) {
+        common = depth;
+        next = n;
+      }
+      depthNodes[depth + 1]++;
+      letterNodes[letter]++;
+      totalNodes++;
+      uint32_t childMask = mask | (1u << letter);
+      if (dict.isWord(child)) {
+        if (depth + 1 > MAX_INDEX_LENGTH) {
+          scannable = false;
+        }
+        masks.push_back(childMask);
+        lengths.push_back(depth + 1);
+        shared.push_back(common);
+        branch.push_back(next);
+        // nothing has changed since this word yet
+        common = SIZE_MAX;
+      }
+      indexHelper(dict, child, depth + 1, childMask, common, next);
+    }
+  }
+
+  /*
+   * function: scan
+   * description: runs the scan plan. Each word writes its child at
+   *   the depth where it parts from the word before, stamped with its
+   *   position. The child a word takes at depth d is the one written
+   *   there if that stamp is newer than every stamp above d, and the
+   *   first child otherwise. path and word hold the nodes and letters
+   *   of the words spelled out so far, correct up to depth built.
+   *
+   * return:  nothing
+   */
+  template <typename Dict>
+  void scan(const Dict &dict, const LetterQuery &query,
+            vector<string> *out) const {
+    uint32_t notAllowed = ~query.allowedMask;
+    uint32_t required = query.requiredMask;
+    size_t shortest = query.minLength;
+    size_t longest = query.maxLength;
+    // per depth, for the word at i
+    uint32_t stamp[MAX_INDEX_LENGTH + 1] = {0};
+    int childIndex[MAX_INDEX_LENGTH + 1];
+    uint32_t path[MAX_INDEX_LENGTH + 1];
+    char word[MAX_INDEX_LENGTH];
+    path[0] = dict.root();
+    size_t built = 0;
+    for (size_t i = 0; i < masks.size(); i++) {
+      size_t common = shared[i];
+      size_t length = lengths[i];
+      stamp[common] = i + 1;
+      childIndex[common] = branch[i];
+      built = min(built, common);
+      if ((masks[i] & notAllowed) != 0 || (masks[i] & required) != required ||
+          length < shortest || length > longest) {
+        continue;
+      }
+      uint32_t newest = 0;
+      for (size_t d = 0; d < built; d++) {
+        newest = max(newest, stamp[d]);
+      }
+      for (; built < length; built++) {
+        int letter;
+        int n = stamp[built] > newest ? childIndex[built] : 0;
+        newest = max(newest, stamp[built]);
+        path[built + 1] = dict.nthChild(path[built], n, letter);
+        word[built] = 'a' + letter;
+      }
+      string found(word, length);
+      if (query.exact && !query.matches(found)) {
+        continue;
+      }
+      out->push_back(found);
+    }
+  }
+
+  double estimateWalk(const LetterQuery &query) const {
+    double allowedNodes = 0;
+    int probes = 0;
+    for (int i = 0; i < 26; i++) {
+      if (query.allowedMask & (1u << i)) {
+        allowedNodes += letterNodes[i];
+        probes++;
+      }
+    }
+    double share = totalNodes > 1 ? allowedNodes / (totalNodes - 1) : 0;
+    double reached = 1; // the root
+    double orderings = 1;
+    for (size_t d = 1; d < depthNodes.size() && d <= query.maxLength; d++) {
+      double atDepth = depthNodes[d] * pow(share, d);
+      if (query.exact) {
+        orderings *= query.maxLength - d + 1;
+        atDepth = min(atDepth, orderings);
+      }
+      reached += atDepth;
+    }
+    return reached * probes * probeCost;
+  }
+
+public:
+  /**
+   * constructor
+   */
+  QueryEngine(double probe = 4)
+      : prepared(false), scannable(false), probeCost(probe) {}
+
+  /*
+   * function: reset
+   * description: drops the index; call whenever the dictionary
+   *   changes.
+   *
+   * parameter: double probe - relative cost of a child probe for the
+   *   new dictionary backend
+   *
+   * return:  nothing
+   */
+  void reset(double probe) {
+    prepared = false;
+    masks.clear();
+    masks.shrink_to_fit();
+    lengths.clear();
+    lengths.shrink_to_fit();
+    shared.clear();
+    shared.shrink_to_fit();
+    branch.clear();
+    branch.shrink_to_fit();
+    probeCost = probe;
+  }
+
+  /*
+   * function: prepare
+   * description: builds the index and the node counts in one walk of
+   *   the trie, which visits the words in sorted order. A word parts
+   *   from the word before at the shallowest depth the walk has
+   *   stepped to a new child since then, and that is the child it
+   *   takes. run calls it on the first query; call it ahead of time
+   *   to take that off the query.
+   *
+   * return:  nothing
+   */
+  template <typename Dict> void prepare(const Dict &dict) {
+    masks.clear();
+    lengths.clear();
+    shared.clear();
+    branch.clear();
+    size_t words = dict.wordCount();
+    masks.reserve(words);
+    lengths.reserve(words);
+    shared.reserve(words);
+    branch.reserve(words);
+    scannable = true;
+    depthNodes.assign(1, 1);
+    for (int i = 0; i < 26; i++) {
+      letterNodes[i] = 0;
+    }
+    totalNodes = 1;
+    size_t common = 0;
+    int next = 0;
+    indexHelper(dict, dict.root(), 0, 0, common, next);
+    if (!scannable) {
+      masks.clear();
+      lengths.clear();
+      shared.clear();
+      branch.clear();
+    }
+    masks.shrink_to_fit();
+    lengths.shrink_to_fit();
+    shared.shrink_to_fit();
+    branch.shrink_to_fit();
+    depthNodes.shrink_to_fit();
+    prepared = true;
+  }
+
+  /*
+   * function: setProbeCost
+   * description: moves to another backend holding the same words; the
+   *   index stays as it is.
+   *
+   * return:  nothing
+   */
+  void setProbeCost(double probe) { probeCost = probe; }
+
+  /*
+   * function: walkFrom
+   * description: runs the walk plan below one node whose path is
+   *   prefix (not checking prefix itself). Used to split a walk over
+   *   several threads.
+   *
+   * return:  nothing
+   */
+  template <typename Dict>
+  void walkFrom(const Dict &dict, const LetterQuery &query, uint32_t node,
+                string prefix, vector<string> *out) const {
+    int remaining[26];
+    uint32_t seenMask = LetterQuery::maskOf(prefix);
+    for (int i = 0; i < 26; i++) {
+      remaining[i] = query.counts[i];
+    }
+    for (auto letter : prefix) {
+      remaining[letter - 'a']--;
+    }
+    walkHelper(dict, query, node, prefix, seenMask, remaining, out);
+  }
+
+  /*
+   * function: plan
+   * description: estimates both plans and picks the cheaper one,
+   *   without running it. The scan is only picked when the index can
+   *   hold every word.
+   *
+   * return:  the plan report, with no words
+   */
+  template <typename Dict>
+  QueryResult plan(const Dict &dict, const LetterQuery &query) {
+    if (!prepared) {
+      prepare(dict);
+    }
+    QueryResult result;
+    result.walkCost = estimateWalk(query);
+    result.scanCost = masks.size();
+    bool walk = !scannable || result.walkCost <= result.scanCost;
+    result.plan = walk ? "walk" : "scan";
+    return result;
+  }
+
+  /*
+   * function: run
+   * description: estimates both plans, runs the cheaper one and times
+   *   it.
+   *
+   * return:  the words, sorted, with the plan report
+   */
+  template <typename Dict>
+  QueryResult run(const Dict &dict, const LetterQuery &query) {
+    QueryResult result = plan(dict, query);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (result.plan == "walk") {
+      walkFrom(dict, query, dict.root(), "", &result.words);
+    } else {
+      scan(dict, query, &result.words);
+    }
+    result.millis = chrono::duration<double, milli>(
+                        chrono::steady_clock::now() - start)
+                        .count();
+    result.found = result.words.size();
+    return result;
+  }
+
+  /*
+   * function: memoryBytes
+   * description: the size of the index and the node counts.
+   *
+   * return:  bytes
+   */
+  size_t memoryBytes() const {
+    return masks.capacity() * sizeof(uint32_t) + lengths.capacity() +
+           shared.capacity() + branch.capacity() +
+           depthNodes.capacity() * sizeof(double);
+  }
+};
+
+#endif
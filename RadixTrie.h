@@ -0,0 +1,419 @@
+
+#ifndef _MY_RADIX_TRIE_H
+#define _MY_RADIX_TRIE_H
+
+#include "TrieStats.h"
+#include "WordReader.h"
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class RadixTrie {
+
+  // Same public interface as Trie, but chains of single-child nodes
+  // are merged into one node holding the whole run of letters
+  // (a Patricia / radix trie). Most of a word list is such chains, so
+  // there are far fewer nodes and a search takes far fewer steps.
+  //
+  // Each node keeps only the children it has, sorted by the first
+  // letter of their label, instead of 26 slots. Those first letters
+  // are also kept in a short string on the node, so picking a child
+  // does not touch every child.
+
+protected:
+  //   definition of radix node structure
+  struct RadixNode {
+    string label;
+    bool isWord;
+    string firstLetters;
+    vector<RadixNode *> children;
+    RadixNode(string l, bool w) : label(l), isWord(w) {}
+  };
+  //   data members
+  RadixNode *root;
+  int wordCounter;
+  int nodeCounter;
+
+  /*
+   * function: findChild
+   * description: finds the position of the child whose label starts
+   *    with the letter, or where it would go to keep them sorted.
+   *
+   * return:  index into node->children
+   */
+  size_t findChild(const RadixNode *node, char letter) const {
+    size_t i = 0;
+    while (i < node->firstLetters.size() && node->firstLetters[i] < letter) {
+      i++;
+    }
+    return i;
+  }
+
+  RadixNode *getChild(const RadixNode *node, char letter) const {
+    size_t i = findChild(node, letter);
+    if (i < node->firstLetters.size() && node->firstLetters[i] == letter) {
+      return node->children[i];
+    }
+    return nullptr;
+  }
+
+  /*
+   * function: mergeWithChild
+   * description: folds the only child of a non-word node into it, so
+   *    no node is left with a single child and no word.
+   *
+   * return:  nothing
+   */
+  void mergeWithChild(RadixNode *node) {
+    RadixNode *child = node->children[0];
+    node->label += child->label;
+    node->isWord = child->isWord;
+    node->children.swap(child->children);
+    node->firstLetters.swap(child->firstLetters);
+    delete child;
+    nodeCounter--;
+  }
+
+  void wordsHelper(const RadixNode *currNode, vector<string> *trieWords,
+                   string &prevChars) const {
+    for (auto child : currNode->children) {
+      prevChars += child->label;
+      if (child->isWord) {
+        trieWords->push_back(prevChars);
+      }
+      wordsHelper(child, trieWords, prevChars);
+      prevChars.resize(prevChars.size() - child->label.size());
+    }
+  }
+
+  /*
+   * function: sbWordsHelper
+   * description: walks only the edges whose letters are all in the
+   *    allowed mask, and keeps the words that are long enough and
+   *    went through the central letter.
+   *
+   * return:  nothing
+   */
+  void sbWordsHelper(const RadixNode *currNode, vector<string> *trieWords,
+                     string &prevChars, uint32_t allowedMask,
+                     char centralLetter, bool hasCentral,
+                     size_t minLength) const {
+    for (auto child : currNode->children) {
+      bool allowed = true;
+      bool central = hasCentral;
+      for (auto letter : child->label) {
+        if (!(allowedMask & (1u << (letter - 'a')))) {
+          allowed = false;
+          break;
+        }
+        central = central || letter == centralLetter;
+      }
+      if (!allowed) {
+        continue;
+      }
+      prevChars += child->label;
+      if (child->isWord && central && prevChars.length() >= minLength) {
+        trieWords->push_back(prevChars);
+      }
+      sbWordsHelper(child, trieWords, prevChars, allowedMask, centralLetter,
+                    central, minLength);
+      prevChars.resize(prevChars.size() - child->label.size());
+    }
+  }
+
+  void clearHelper(RadixNode *currentNode) {
+    for (auto child : currentNode->children) {
+      clearHelper(child);
+    }
+    delete currentNode;
+  }
+
+  void statsHelper(const RadixNode *currNode, int depth,
+                   TrieStats &stats) const {
+    stats.addNode(depth, currNode->children.size(), currNode->isWord);
+    stats.emptySlots +=
+        currNode->children.capacity() - currNode->children.size();
+    for (auto child : currNode->children) {
+      statsHelper(child, depth + 1, stats);
+    }
+  }
+
+  size_t memoryHelper(const RadixNode *currNode) const {
+    size_t bytes = sizeof(RadixNode) +
+                   currNode->children.capacity() * sizeof(RadixNode *);
+    // strings longer than the small string buffer live on the heap
+    if (currNode->label.capacity() > string().capacity()) {
+      bytes += currNode->label.capacity() + 1;
+    }
+    if (currNode->firstLetters.capacity() > string().capacity()) {
+      bytes += currNode->firstLetters.capacity() + 1;
+    }
+    for (auto child : currNode->children) {
+      bytes += memoryHelper(child);
+    }
+    return bytes;
+  }
+
+  bool isValidWord(const string &word) const {
+    for (auto character : word) {
+      if (character < 'a' || character > 'z') {
+        return false;
+      }
+    }
+    return true;
+  }
+
+public:
+  /**
+   * constructor and destructor
+   */
+  RadixTrie() {
+    root = new RadixNode("", false);
+    wordCounter = 0;
+    nodeCounter = 1;
+  }
+  ~RadixTrie() { clearHelper(root); }
+
+  /*
+   * function: getFromFile
+   * description:  extract all of the words from the file
+   *   specified by the filename given in the parameter.
+   *   Words are separated by whitespace characters and
+   *   must only contain letters.
+   *
+   * return:  indicates success/failure (file not readable...)
+   */
+  bool getFromFile(string filename) {
+    return WordReader::readWords(filename, [this](const char *word,
+                                                  size_t length) {
+      insert(string(word, length));
+    });
+  }
+
+  /*
+   * function: insert
+   * description:  inserts the word given by the parameter. If the
+   *   word leaves an edge part way through its label, the edge is
+   *   split at that point.
+   *
+   *   fails if word already exists or contains non-letters
+   *
+   * return:  indicates success/failure
+   */
+  bool insert(string word) {
+    if (word.empty() || !isValidWord(word)) {
+      return false;
+    }
+    RadixNode *currentNode = root;
+    size_t pos = 0;
+    while (pos < word.length()) {
+      size_t i = findChild(currentNode, word[pos]);
+      vector<RadixNode *> &children = currentNode->children;
+      if (i == children.size() || currentNode->firstLetters[i] != word[pos]) {
+        // Nothing shares this letter, the rest of the word is a new leaf
+        children.insert(children.begin() + i,
+                        new RadixNode(word.substr(pos), true));
+        currentNode->firstLetters.insert(i, 1, word[pos]);
+        nodeCounter++;
+        wordCounter++;
+        return true;
+      }
+      RadixNode *child = children[i];
+      size_t common = 1;
+      while (common < child->label.length() && pos + common < word.length() &&
+             child->label[common] == word[pos + common]) {
+        common++;
+      }
+      if (common < child->label.length()) {
+        // Split the edge: the shared part becomes a new node above child
+        RadixNode *middle = new RadixNode(child->label.substr(0, common), false);
+        child->label.erase(0, common);
+        middle->children.push_back(child);
+        middle->firstLetters.push_back(child->label[0]);
+        children[i] = middle;
+        nodeCounter++;
+        child = middle;
+      }
+      currentNode = child;
+      pos += common;
+    }
+    if (currentNode->isWord) {
+      return false;
+    }
+    currentNode->isWord = true;
+    wordCounter++;
+    return true;
+  }
+
+  /*
+   * function: search
+   * description:  determines if the word given by the parameter
+   *   is stored in the trie.
+   *
+   * return:  indicates success/failure
+   */
+  bool search(const string &word) const {
+    const RadixNode *currentNode = root;
+    size_t pos = 0;
+    while (pos < word.length()) {
+      const RadixNode *child = getChild(currentNode, word[pos]);
+      if (child == nullptr ||
+          word.compare(pos, child->label.length(), child->label) != 0) {
+        return false;
+      }
+      pos += child->label.length();
+      currentNode = child;
+    }
+    return currentNode != root && currentNode->isWord;
+  }
+
+  /*
+   * function: remove
+   * description:  removes the word given by the parameter. A node
+   *   left without a word or children is deleted, and a node left
+   *   with no word and one child is merged with that child.
+   *
+   *   succeed if word exists and is properly removed
+   *
+   * return:  indicates success/failure
+   */
+  bool remove(string word) {
+    RadixNode *parent = nullptr;
+    RadixNode *currentNode = root;
+    size_t pos = 0;
+    while (pos < word.length()) {
+      RadixNode *child = getChild(currentNode, word[pos]);
+      if (child == nullptr ||
+          word.compare(pos, child->label.length(), child->label) != 0) {
+        return false;
+      }
+      pos += child->label.length();
+      parent = currentNode;
+      currentNode = child;
+    }
+    if (currentNode == root || !currentNode->isWord) {
+      return false;
+    }
+    currentNode->isWord = false;
+    wordCounter--;
+    if (currentNode->children.empty()) {
+      size_t i = findChild(parent, currentNode->label[0]);
+      parent->children.erase(parent->children.begin() + i);
+      parent->firstLetters.erase(i, 1);
+      delete currentNode;
+      nodeCounter--;
+      if (parent != root && !parent->isWord && parent->children.size() == 1) {
+        mergeWithChild(parent);
+      }
+    } else if (currentNode->children.size() == 1) {
+      mergeWithChild(currentNode);
+    }
+    return true;
+  }
+
+  /*
+   * function: clear
+   * description:  remove all words from the trie and deallocate
+   *   all nodes.
+   *
+   * return:  indicates success/failure
+   */
+  bool clear() {
+    clearHelper(root);
+    root = new RadixNode("", false);
+    wordCounter = 0;
+    nodeCounter = 1;
+    return true;
+  }
+
+  /*
+   * function: wordCount
+   * description:  return the number of words currently stored
+   *
+   * return:  an integer containing the number of words stored
+   */
+  int wordCount() const { return wordCounter; }
+
+  /*
+   * function: nodeCount
+   * description:  return the number of nodes, including the root
+   *
+   * return:  an integer containing the number of nodes
+   */
+  int nodeCount() const { return nodeCounter; }
+
+  /*
+   * function: memoryBytes
+   * description:  adds up the node, label and child list storage
+   *   (not counting allocator overhead).
+   *
+   * return:  the number of bytes used by the nodes
+   */
+  size_t memoryBytes() const { return memoryHelper(root); }
+
+  /*
+   * function: stats
+   * description:  counts nodes, bytes, unused child list capacity,
+   *   fan-out and depth (see TrieStats).
+   *
+   * return:  the stats
+   */
+  TrieStats stats() const {
+    TrieStats trieStats;
+    statsHelper(root, 0, trieStats);
+    trieStats.bytes = memoryBytes();
+    return trieStats;
+  }
+
+  /*
+   * function: words
+   * description:  build a vector of all words in the trie in sorted
+   *   ascending order.
+   *
+   * return:  a pointer to a vector of strings
+   */
+  vector<string> *words() const {
+    vector<string> *trieWords = new vector<string>();
+    string prevChars;
+    wordsHelper(root, trieWords, prevChars);
+    return trieWords;
+  }
+
+  /*
+   * function: sbWords
+   * description:  build a vector of the Spelling Bee words: made only
+   *   of the allowed letters, containing the central letter and at
+   *   least minLength long. The words are in sorted ascending order.
+   *
+   * return:  a pointer to a vector of strings
+   */
+  vector<string> *sbWords(char centralLetter, string letters,
+                          size_t minLength = 4) const {
+    uint32_t allowedMask = 0;
+    for (auto letter : letters) {
+      if (letter >= 'a' && letter <= 'z') {
+        allowedMask |= 1u << (letter - 'a');
+      }
+    }
+    vector<string> *trieWords = new vector<string>();
+    string prevChars;
+    sbWordsHelper(root, trieWords, prevChars, allowedMask, centralLetter,
+                  false, minLength);
+    return trieWords;
+  }
+
+  /*
+   * function: hasWordStartingWith
+   * description:  checks if any stored word begins with the letter.
+   *
+   * return:  indicates success/failure
+   */
+  bool hasWordStartingWith(char letter) const {
+    return getChild(root, letter) != nullptr;
+  }
+};
+
+#endif
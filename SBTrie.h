@@ -2,12 +2,20 @@
 #ifndef _MY_SB_TRIE_H
 #define _MY_SB_TRIE_H
 
+#include "DictionaryLoader.h"
+#include "FrozenTrie.h"
+#include "LoudsTrie.h"
+#include "QueryEngine.h"
+#include "RadixTrie.h"
+#include "SessionJournal.h"
 #include "Trie.h"
 #include <cctype>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 class SBTrie : public Trie {
 
@@ -28,9 +36,17 @@ protected:
   string allowedLetters;
   int score;
   Trie *dictionary;
-  Trie *wordsFoundSoFar;
+  FrozenTrie *frozenDictionary;
+  LoudsTrie *compactDictionary;
+  bool compactMode;
+  QueryEngine *queryEngine;
+  QueryResult *lastQuery; // plan and timing of the last query, no words
+  RadixTrie *wordsFoundSoFar;
   bool pangramFound;
   bool bingoFound;
+  SessionJournal *journal;
+  uint32_t journalSession;
+  DictionaryLoader *loader;
   //   definition of trie node structure
   //   private helper functions
   bool contains(vector<char> letters, char input) {
@@ -42,6 +58,237 @@ protected:
     }
     return false;
   }
+  // one independent piece of a parallel walk: the subtree below
+  // node, whose letters so far are prefix. When descend is false only
+  // the prefix itself is checked (its children are separate tasks).
+  struct SBTask {
+    uint32_t node;
+    string prefix;
+    bool descend;
+    SBTask(uint32_t n, string p, bool d) : node(n), prefix(p), descend(d) {}
+  };
+
+  /*
+   * function: splitTasks
+   * description: replaces every branch task with a check of the
+   *    branch word itself followed by one task per allowed child,
+   *    keeping the tasks in alphabetical order.
+   *
+   * return:  the new list of tasks
+   */
+  template <typename Dict>
+  vector<SBTask> splitTasks(const Dict &dict, const LetterQuery &query,
+                            const vector<SBTask> &tasks) const {
+    vector<SBTask> split;
+    for (auto &task : tasks) {
+      split.push_back(SBTask(task.node, task.prefix, false));
+      for (int letter = 0; letter < 26; letter++) {
+        if (!(query.allowedMask & (1u << letter))) {
+          continue;
+        }
+        uint32_t child = dict.child(task.node, letter);
+        if (child != Dict::npos) {
+          split.push_back(SBTask(child, task.prefix + char('a' + letter), true));
+        }
+      }
+    }
+    return split;
+  }
+
+  /*
+   * function: runTask
+   * description: solves one task into its own result vector.
+   *
+   * return:  nothing
+   */
+  template <typename Dict>
+  void runTask(const Dict &dict, const LetterQuery &query, const SBTask &task,
+               vector<string> *trieWords) const {
+    if (dict.isWord(task.node) && query.matches(task.prefix)) {
+      trieWords->push_back(task.prefix);
+    }
+    if (task.descend) {
+      queryEngine->walkFrom(dict, query, task.node, task.prefix, trieWords);
+    }
+  }
+
+  /*
+   * function: parallelWalk
+   * description: the body of sbWordsParallel for one dictionary
+   *    backend. Only for queries without exact letter counts.
+   *
+   * return:  a pointer to a vector of strings
+   */
+  template <typename Dict>
+  vector<string> *parallelWalk(const Dict &dict, const LetterQuery &query,
+                               unsigned threads) const {
+    // Collect the top level branches and a rough size for each
+    // (number of children one level down)
+    uint32_t root = dict.root();
+    vector<SBTask> tasks;
+    vector<int> branchSize;
+    int totalSize = 0;
+    for (int letter = 0; letter < 26; letter++) {
+      if (!(query.allowedMask & (1u << letter))) {
+        continue;
+      }
+      uint32_t child = dict.child(root, letter);
+      if (child != Dict::npos) {
+        tasks.push_back(SBTask(child, string(1, 'a' + letter), true));
+        branchSize.push_back(dict.childCount(child));
+        totalSize += branchSize.back();
+      }
+    }
+    if (tasks.empty()) {
+      return new vector<string>();
+    }
+    int biggest = *max_element(branchSize.begin(), branchSize.end());
+    bool skewed = biggest * (int)tasks.size() > 2 * totalSize;
+    if (tasks.size() < threads || skewed) {
+      tasks = splitTasks(dict, query, tasks);
+    }
+    // Workers pull the next task index until none are left
+    vector<vector<string>> results(tasks.size());
+    atomic<size_t> nextTask(0);
+    auto worker = [&]() {
+      size_t t;
+      while ((t = nextTask++) < tasks.size()) {
+        runTask(dict, query, tasks[t], &results[t]);
+      }
+    };
+    vector<thread> workers;
+    for (unsigned i = 0; i < threads && i < tasks.size(); i++) {
+      workers.push_back(thread(worker));
+    }
+    for (auto &w : workers) {
+      w.join();
+    }
+    // Tasks are in alphabetical order, so appending keeps it sorted
+    size_t total = 0;
+    for (auto &r : results) {
+      total += r.size();
+    }
+    vector<string> *trieWords = new vector<string>();
+    trieWords->reserve(total);
+    for (auto &r : results) {
+      move(r.begin(), r.end(), back_inserter(*trieWords));
+    }
+    return trieWords;
+  }
+
+  /*
+   * function: freeze
+   * description: packs a freshly loaded dictionary into its read-only
+   *    layout, which is what searches and sbWords walk, and builds the
+   *    query index from it, so the first query after a load does not
+   *    wait for it. The editable Trie is only needed to build it and
+   *    is emptied afterwards. In compact mode the packed copy is
+   *    turned into the succinct one and only that is kept. Each
+   *    step is counted in progress, and none starts once the load is
+   *    cancelled.
+   *
+   * return:  indicates success/failure (cancelled)
+   */
+  static bool freeze(DictionaryLoader::Dictionary &dict, bool compact,
+                     LoadProgress *progress) {
+    if (!progress->step(PACK_WEIGHT)) {
+      return false;
+    }
+    dict.frozen->build(*dict.editable);
+    if (!progress->step(CLEAR_WEIGHT)) {
+      return false;
+    }
+    dict.editable->clear();
+    if (!progress->step(INDEX_WEIGHT)) {
+      return false;
+    }
+    // the same either way, and far quicker to walk in the packed copy
+    dict.engine->prepare(*dict.frozen);
+    if (compact) {
+      if (!progress->step(SUCCINCT_WEIGHT)) {
+        return false;
+      }
+      dict.compact->build(*dict.frozen);
+      dict.frozen->clear();
+    }
+    return true;
+  }
+
+  // rough share of a load's time taken by each step, for its progress
+  static const int SEED_WEIGHT = 7; // current words into the new Trie
+  static const int READ_WEIGHT = 4; // then the file
+  static const int PACK_WEIGHT = 3;
+  static const int CLEAR_WEIGHT = 3;
+  static const int INDEX_WEIGHT = 1;
+  static const int SUCCINCT_WEIGHT = 3;
+
+  // a child probe costs a few index checks in the packed array and
+  // far more as rank/select steps in the succinct one
+  static double probeCost(bool compact) { return compact ? 64 : 4; }
+
+  DictionaryLoader::Dictionary currentDictionary() const {
+    DictionaryLoader::Dictionary dict;
+    dict.editable = dictionary;
+    dict.frozen = frozenDictionary;
+    dict.compact = compactDictionary;
+    dict.engine = queryEngine;
+    return dict;
+  }
+
+  /*
+   * function: startLoad
+   * description: queues a background build of a new dictionary from
+   *    the file, on top of the words of the current one when adding.
+   *    The current dictionary stays in use, and is only read, until
+   *    the new one is swapped in. A file that cannot be read fails
+   *    the build and the current dictionary is kept. A cancelled load
+   *    stops at its next step (see freeze) or block of the file.
+   *
+   * return:  indicates success/failure (a load is already running)
+   */
+  bool startLoad(string filename, bool add) {
+    const FrozenTrie *frozen = frozenDictionary;
+    const LoudsTrie *compactCopy = compactDictionary;
+    bool compact = compactMode;
+    return loader->start(filename, [=](DictionaryLoader::Dictionary &next,
+                                       LoadProgress *progress) {
+      progress->totalWeight = (add ? SEED_WEIGHT : 0) + READ_WEIGHT +
+                              PACK_WEIGHT + CLEAR_WEIGHT + INDEX_WEIGHT +
+                              (compact ? SUCCINCT_WEIGHT : 0);
+      next.editable = new Trie();
+      if (add) {
+        if (!progress->step(SEED_WEIGHT, true)) {
+          return false;
+        }
+        vector<string> *words =
+            compact ? compactCopy->words() : frozen->words();
+        next.editable->insertSorted(*words, &progress->file);
+        delete words;
+      }
+      if (!progress->step(READ_WEIGHT, true) ||
+          !next.editable->getFromFile(filename, &progress->file)) {
+        return false;
+      }
+      next.frozen = new FrozenTrie();
+      next.compact = new LoudsTrie();
+      next.engine = new QueryEngine(probeCost(compact));
+      return freeze(next, compact, progress);
+    });
+  }
+
+  /*
+   * function: dictionarySearch
+   * description: looks the word up in whichever read-only dictionary
+   *    is in use.
+   *
+   * return:  indicates success/failure
+   */
+  bool dictionarySearch(const string &word) const {
+    if (compactMode) {
+      return compactDictionary->search(word);
+    }
+    return frozenDictionary->search(word);
+  }
   //   etc.
 
 public:
@@ -51,45 +298,63 @@ public:
   SBTrie() {
     // your constructor code here!
     score = 0;
-    wordsFoundSoFar = new Trie();
+    centralLetter = 0;
+    wordsFoundSoFar = new RadixTrie();
     dictionary = new Trie();
+    frozenDictionary = new FrozenTrie();
+    compactDictionary = new LoudsTrie();
+    compactMode = false;
+    queryEngine = new QueryEngine();
+    lastQuery = new QueryResult();
     pangramFound = false;
     bingoFound = false;
+    journal = nullptr;
+    journalSession = 0;
+    loader = new DictionaryLoader();
   }
   ~SBTrie() {
     // your destructor code here.
+    // stops a load still running and frees what it built
+    bool exiting = loader->abandoned();
+    delete loader;
+    if (exiting) {
+      // an abandoned load may still be reading the dictionary, and it
+      // all goes back to the OS anyway
+      return;
+    }
     wordsFoundSoFar->clear();
     delete wordsFoundSoFar;
     dictionary->clear();
     delete dictionary;
+    delete frozenDictionary;
+    delete compactDictionary;
+    delete queryEngine;
+    delete lastQuery;
   }
   /*
-   * function: sbWordsHelper
-   * description: Goes through all the nodes in the trie
-   *    by using recursion. Loops the letters and adds
-   *    only the valid words to the vector.
+   * function: runQuery
+   * description: runs any letter query against the dictionary (see
+   *   LetterQuery for the kinds of games it covers). The engine picks
+   *   a trie walk or an index scan from its cost estimates; the plan
+   *   and time are kept for explainLastQuery.
    *
-   * return:  nothing
+   * parameter: LetterQuery query - the words wanted
+   *
+   * return:  the sorted words with the plan report
    */
-  void sbWordsHelper(TrieNode *currNode, vector<string> *trieWords, string prevChars) const {
-    // loop through the allowed letters
-    for ( auto letter : allowedLetters){
-      int index = (int)letter - (int)'a';
-      // check if letter is a next node
-      if (currNode->letters[index] != nullptr){
-        // check if it is a word
-        if (currNode->letters[index]->isWord){
-          string word = prevChars + letter;
-          // check if its a valid word and add it
-          bool cLetter = (word.find(centralLetter) != string::npos);
-          if (word.length() >= 4 && cLetter){
-            trieWords->push_back(word);
-          }
-        }
-        sbWordsHelper(currNode->letters[index], trieWords, prevChars + letter);
-      }
+  QueryResult runQuery(const LetterQuery &query) const {
+    QueryResult result;
+    if (compactMode) {
+      result = queryEngine->run(*compactDictionary, query);
+    } else {
+      result = queryEngine->run(*frozenDictionary, query);
     }
+    *lastQuery = result;
+    lastQuery->words.clear();
+    lastQuery->words.shrink_to_fit();
+    return result;
   }
+
   /*
    * function: sbWords
    * description:  build a vector of all words in the dictionary that
@@ -106,36 +371,193 @@ public:
    *
    */
   std::vector<string> *sbWords(char centralLetter, string letters) const {
-    vector<string> *trieWords = new vector<string>();
-    sbWordsHelper(dictionary->getRoot(), trieWords, "");
+    QueryResult result =
+        runQuery(LetterQuery::spellingBee(centralLetter, letters));
+    return new vector<string>(move(result.words));
+  }
+
+  /*
+   * function: sbWordsParallel
+   * description:  same result as sbWords, but the allowed letter
+   *   subtrees of the dictionary are solved on worker threads.
+   *   Each subtree is an independent task whose words come out
+   *   sorted, so the results are joined back in task order.
+   *   When there are more threads than branches, or one branch
+   *   is much bigger than the rest, the branches are split again
+   *   at depth 2 so the work is spread more evenly.
+   *   Only done when the query engine would walk; when it would
+   *   scan, the scan runs as in sbWords.
+   *
+   * parameter: unsigned threads - number of workers, 0 picks the
+   *   hardware concurrency
+   *
+   * return:  a pointer to a vector of strings
+   *
+   */
+  std::vector<string> *sbWordsParallel(char centralLetter, string letters,
+                                       unsigned threads = 0) const {
+    if (threads == 0) {
+      threads = thread::hardware_concurrency();
+    }
+    if (threads <= 1) {
+      return sbWords(centralLetter, letters);
+    }
+    LetterQuery query = LetterQuery::spellingBee(centralLetter, letters);
+    QueryResult result = compactMode ? queryEngine->plan(*compactDictionary, query)
+                                     : queryEngine->plan(*frozenDictionary, query);
+    if (result.plan != "walk") {
+      return sbWords(centralLetter, letters);
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<string> *trieWords;
+    if (compactMode) {
+      trieWords = parallelWalk(*compactDictionary, query, threads);
+    } else {
+      trieWords = parallelWalk(*frozenDictionary, query, threads);
+    }
+    *lastQuery = result;
+    lastQuery->plan = "parallel walk";
+    lastQuery->found = trieWords->size();
+    lastQuery->millis = chrono::duration<double, milli>(
+                            chrono::steady_clock::now() - start)
+                            .count();
     return trieWords;
   }
 
   /*
    * function: setNewDictionary
-   * description:  removes the existing dictionary from the trie and
-   *		insert the new file into the trie.
+   * description:  replaces the existing dictionary with the words of
+   *		the file, and returns once the new one is in use.
    *
    * parameter: string filename - file the we are going to use to
    * read in words.
    *
+   * return:  indicates success/failure (file not readable, the old
+   *   dictionary is kept)
+   */
+  bool setNewDictionary(string filename) {
+    switchDictionary(true);
+    startLoad(filename, false);
+    return switchDictionary(true) == DictionaryLoader::LOADED;
+  }
+
+  /*
+   * function: loadNewDictionary / loadIntoDictionary
+   * description:  start replacing the dictionary with the words of
+   *		the file, or adding them to it, in the background. The game
+   *		goes on with the current dictionary; switchDictionary puts
+   *		the new one in use when it is ready.
+   *
+   * parameter: string filename - file to read words from
+   *
+   * return:  indicates success/failure (a load is already running)
+   */
+  bool loadNewDictionary(string filename) {
+    return startLoad(filename, false);
+  }
+
+  bool loadIntoDictionary(string filename) {
+    return startLoad(filename, true);
+  }
+
+  /*
+   * function: switchDictionary
+   * description:  if a background load has finished, puts the new
+   *		dictionary in use and hands the old one to the loader
+   *		thread to free. Call between commands.
+   *
+   * parameter: bool wait - wait for a load still running
+   *
+   * return:  LOADED when the new dictionary is in use, FAILED when the
+   *   load failed and the current one is kept, NONE when no load has
+   *   finished
+   */
+  DictionaryLoader::Outcome switchDictionary(bool wait) {
+    DictionaryLoader::Dictionary next;
+    DictionaryLoader::Outcome outcome = loader->take(next, wait);
+    if (outcome != DictionaryLoader::LOADED) {
+      return outcome;
+    }
+    loader->retire(currentDictionary());
+    dictionary = next.editable;
+    frozenDictionary = next.frozen;
+    compactDictionary = next.compact;
+    queryEngine = next.engine;
+    return outcome;
+  }
+
+  /*
+   * function: loadProgress
+   * description:  how far a background load has got.
+   *
+   * return:  percent done, or -1 when nothing is loading
+   */
+  int loadProgress() {
+    return loader->busy() ? loader->percent() : -1;
+  }
+
+  string loadingFile() { return loader->name(); }
+
+  /*
+   * function: abandonLoading
+   * description:  call when the program is about to exit: a running
+   *    load is cancelled and not waited for, and nothing the game
+   *    holds is freed when it is deleted; the OS takes it all back
+   *    at once.
+   *
    * return:  void
    */
-  void setNewDictionary(string filename) {
-    dictionary->clear();
-    dictionary->getFromFile(filename);
+  void abandonLoading() { loader->abandon(); }
+
+  /*
+   * function: setCompactDictionary
+   * description:  switches the dictionary between the packed
+   *		FrozenTrie (fastest) and the succinct LoudsTrie (a few bits
+   *		per node). Only the one in use is kept. The succinct copy is
+   *		built straight from the packed one; going back, its words
+   *		(listed in sorted order) are loaded into the editable Trie
+   *		to pack them again.
+   *
+   * parameter: bool compact - true for the succinct dictionary
+   *
+   * return:  void
+   */
+  void setCompactDictionary(bool compact) {
+    switchDictionary(true);
+    if (compact == compactMode) {
+      return;
+    }
+    if (compact) {
+      compactDictionary->build(*frozenDictionary);
+      frozenDictionary->clear();
+    } else {
+      vector<string> *words = compactDictionary->words();
+      dictionary->insertSorted(*words);
+      delete words;
+      frozenDictionary->build(*dictionary);
+      dictionary->clear();
+      *compactDictionary = LoudsTrie();
+    }
+    compactMode = compact;
+    // same words, so the query index still holds
+    queryEngine->setProbeCost(probeCost(compactMode));
   }
 
   /*
    * function: addToDictionary
-   * description:  adds onto the existing dictionary by insert the file
-   *		data into the dictionary trie.
+   * description:  adds the words of the file to the existing
+   *		dictionary, and returns once the result is in use.
    *
    * parameter: string filename - file that is opened and read from.
    *
-   * return:  void
+   * return:  indicates success/failure (file not readable, the
+   *   dictionary is left as it was)
    */
-  void addToDictionary(string filename) { dictionary->getFromFile(filename); }
+  bool addToDictionary(string filename) {
+    switchDictionary(true);
+    startLoad(filename, true);
+    return switchDictionary(true) == DictionaryLoader::LOADED;
+  }
 
   /*
    * function: setLetters
@@ -168,6 +590,55 @@ public:
     score = 0;
     pangramFound = false;
     bingoFound = false;
+    if (journal != nullptr) {
+      journal->logLetters(journalSession, centralLetter, allowedLetters);
+    }
+  }
+
+  /*
+   * function: attachJournal
+   * description:  logs every new letter set and found word of this
+   *		game to the journal from now on, as the given session.
+   *
+   * parameter: SessionJournal *newJournal - journal to log to (not
+   *		owned), or nullptr to stop logging
+   *            uint32_t session - session number in the journal
+   *
+   * return:  void
+   */
+  void attachJournal(SessionJournal *newJournal, uint32_t session) {
+    journal = newJournal;
+    journalSession = session;
+  }
+
+  /*
+   * function: restoreSession
+   * description:  puts the game back in a state recovered from the
+   *		journal: the letters, then every found word in order, with
+   *		score, pangram and bingo worked out again. The words were
+   *		checked when they were first found, so the dictionary is not
+   *		needed. Nothing is logged.
+   *
+   * parameter: SessionState state - recovered session
+   *
+   * return:  void
+   */
+  void restoreSession(const SessionJournal::SessionState &state) {
+    centralLetter = state.centralLetter;
+    allowedLetters = state.allowedLetters;
+    wordsFoundSoFar->clear();
+    score = 0;
+    pangramFound = false;
+    bingoFound = false;
+    for (auto &word : state.words) {
+      if (wordsFoundSoFar->insert(word)) {
+        bool isPangram = false;
+        score += calculateScore(word, isPangram);
+      }
+    }
+    if (!allowedLetters.empty()) {
+      checkForBingo();
+    }
   }
 
   /*
@@ -264,14 +735,10 @@ public:
    * return:  indicates success/failure
    */
   bool checkForBingo() {
-    // Temporary pointer to the root
-    TrieNode *currentNode = wordsFoundSoFar->getRoot();
     // Loop through every letter in the allowed letters
     for (auto letter : allowedLetters) {
-      // Index where the current character should be
-      int index = letter - 'a';
       // Check if theres a word with the starting letter
-      if (currentNode->letters[index] == nullptr) {
+      if (!wordsFoundSoFar->hasWordStartingWith(letter)) {
         // No bingo
         return false;
       }
@@ -319,7 +786,7 @@ public:
       cout << "word contains invalid letter" << endl;
       return;
     }
-    bool isWord = dictionary->search(input);
+    bool isWord = dictionarySearch(input);
     bool inputIsPangram = false;
     bool inputIsBingo = false;
     // Checks if the word is not in the dictionary
@@ -334,6 +801,9 @@ public:
       } else {
         // word is not discovered yet
         wordsFoundSoFar->insert(input);
+        if (journal != nullptr) {
+          journal->logWord(journalSession, input);
+        }
         cout << "found " << input << " ";
         // Do score calculation
         int currentScore = calculateScore(input, inputIsPangram);
@@ -384,18 +854,91 @@ public:
     delete words;
   }
 
+  /*
+   * function: memoryReport
+   * description: prints the size and shape of every trie the game
+   *  holds: the editable dictionary (empty once a load is done), both
+   *  read-only copies (only the one in use holds the words, the other
+   *  is an empty root) and the words found so far, then the size of
+   *  the query index and the total bytes.
+   *
+   * parameter: bool machine - name.key=value lines instead of the
+   *  readable summary
+   *
+   * return:  void
+   */
+  void memoryReport(bool machine) {
+    TrieStats editable = dictionary->stats();
+    TrieStats frozen = frozenDictionary->stats();
+    TrieStats compact = compactDictionary->stats();
+    TrieStats found = wordsFoundSoFar->stats();
+    long index = queryEngine->memoryBytes();
+    editable.print(cout, "dictionary", machine);
+    frozen.print(cout, "frozen", machine);
+    compact.print(cout, "compact", machine);
+    found.print(cout, "found", machine);
+    long total =
+        editable.bytes + frozen.bytes + compact.bytes + found.bytes + index;
+    if (machine) {
+      cout << "index.bytes=" << index << endl;
+      cout << "total.bytes=" << total << endl;
+    } else {
+      cout << "query index: " << index << " bytes" << endl;
+      cout << "total: " << total << " bytes" << endl;
+    }
+  }
+
+  /*
+   * function: getAnagrams
+   * description: display every dictionary word that uses exactly the
+   *  given letters, 1 per line, then how the query ran.
+   *
+   * parameter: string letters - the letters to rearrange
+   *
+   * return:  void
+   */
+  void getAnagrams(string letters) {
+    for (auto &letter : letters) {
+      letter = tolower(letter);
+    }
+    QueryResult result = runQuery(LetterQuery::anagramOf(letters));
+    for (auto &word : result.words) {
+      cout << word << endl;
+    }
+    result.print(cout);
+  }
+
+  /*
+   * function: explainLastQuery
+   * description: display the plan, cost estimates and time of the
+   *  last word query (command 7 or an anagram search).
+   *
+   * return:  void
+   */
+  void explainLastQuery() {
+    if (lastQuery->plan.empty()) {
+      cout << "no query has been run" << endl;
+      return;
+    }
+    lastQuery->print(cout);
+  }
+
   /*
    * function: getAllWords
    * description: display all spelling bee words
    *  1 per line and the length of the word after 20
-   *  characters/spaces and Pangram status.
+   *  characters/spaces and Pangram status. Nothing is shown
+   *  before the letters are set.
    *
    * parameter: None
    *
    * return:  void
    */
   void getAllWords() {
-    vector<string> *words = sbWords(centralLetter, allowedLetters);
+    if (allowedLetters.empty()) {
+      return;
+    }
+    vector<string> *words = sbWordsParallel(centralLetter, allowedLetters);
     for (auto word : *words){
       // if word is too long just print word and 1 space
       if (word.length() > 17){
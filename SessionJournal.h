@@ -0,0 +1,481 @@
+
+#ifndef _MY_SESSION_JOURNAL_H
+#define _MY_SESSION_JOURNAL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+using namespace std;
+
+class SessionJournal {
+
+  // Keeps game progress on disk so it survives the process dying.
+  //
+  // Every accepted letter set and found word is appended as a small
+  // record to an in-memory buffer, which is all a guess has to wait
+  // for. A background thread writes the buffer out and fsyncs it a
+  // few milliseconds after the first record arrives (group commit),
+  // so many guesses share one fsync. With nothing queued it sleeps.
+  //
+  // If a write or fsync fails, the file is cut back to its last good
+  // record and the journal stops taking records; sync() reports it.
+  //
+  // Records wait in one of two buffers of fixed size: appends fill
+  // one while the background thread writes the other, so an append
+  // never reallocates. If the disk falls so far behind that the
+  // buffer is full, an append waits for the next write.
+  //
+  // When the journal grows past a limit, a second thread moves it
+  // aside, folds it into a snapshot holding just the current state
+  // of each session (written to a temp file, then renamed), and
+  // deletes it. Group commits go on while it does.
+  //
+  // open() rebuilds every session from the snapshot, any journal
+  // moved aside but not yet folded in, and the journal, in that
+  // order. A record cut short by a crash ends the replay, and the
+  // journal is truncated back to its last whole record.
+  //
+  // Record layout: type (1 byte), session (4), length (2), payload,
+  // checksum (4) over everything before it. Snapshots use the same
+  // records.
+
+public:
+  //   state of one session, as rebuilt from the files
+  struct SessionState {
+    char centralLetter;
+    string allowedLetters;
+    vector<string> words; // in the order they were found
+    SessionState() : centralLetter(0) {}
+  };
+
+protected:
+  enum RecordType { SET_LETTERS = 1, FOUND_WORD = 2 };
+  static const size_t HEADER_SIZE = 7;
+  static const size_t CHECKSUM_SIZE = 4;
+  // how long appended records may wait for the next fsync
+  static constexpr int GROUP_COMMIT_MS = 5;
+  // write out early once this much is waiting
+  static const size_t GROUP_COMMIT_BYTES = 1 << 16;
+  // size of each record buffer; appends wait beyond this
+  static const size_t PENDING_BYTES = 1 << 18;
+  // fold the journal into the snapshot once it is this big, and at
+  // least as big as the snapshot, so rewriting the snapshot stays
+  // in proportion to what was logged
+  static const off_t COMPACT_BYTES = 1 << 22;
+
+  //   data members
+  string journalPath;
+  // the journal file, its size and the snapshot size are shared by
+  // the flusher and the compactor under fileLock
+  int fd;
+  off_t journalSize;
+  off_t snapshotSize;
+  mutex fileLock;
+  // the rest under lock
+  string pending; // records not written yet
+  string writing; // records being written (flusher only)
+  uint64_t appended;
+  uint64_t durable;
+  bool stopping;
+  bool active; // open and taking records
+  bool failed; // a write failed, records are no longer kept
+  bool compactWanted;
+  mutex lock;
+  condition_variable wake;
+  condition_variable synced;
+  condition_variable drained;
+  condition_variable compactWake;
+  thread flusher;
+  thread compactor;
+
+  static uint32_t checksum(const char *data, size_t length) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+      hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+    }
+    return hash;
+  }
+
+  static void encode(string &out, RecordType type, uint32_t session,
+                     const string &payload) {
+    size_t start = out.size();
+    uint16_t length = payload.size();
+    out.push_back((char)type);
+    out.append((const char *)&session, 4);
+    out.append((const char *)&length, 2);
+    out.append(payload);
+    uint32_t sum = checksum(out.data() + start, out.size() - start);
+    out.append((const char *)&sum, 4);
+  }
+
+  /*
+   * function: apply
+   * description: replays one record onto the session states. Found
+   *   words already present are skipped, so replaying a journal that
+   *   is also in the snapshot changes nothing.
+   *
+   * return:  nothing
+   */
+  static void apply(map<uint32_t, SessionState> &sessions, int type,
+                    uint32_t session, const string &payload) {
+    SessionState &state = sessions[session];
+    if (type == SET_LETTERS && !payload.empty()) {
+      state.centralLetter = payload[0];
+      state.allowedLetters = payload.substr(1);
+      state.words.clear();
+    } else if (type == FOUND_WORD) {
+      for (auto &word : state.words) {
+        if (word == payload) {
+          return;
+        }
+      }
+      state.words.push_back(payload);
+    }
+  }
+
+  /*
+   * function: replayFile
+   * description: applies every whole, valid record of the file.
+   *
+   * return:  the number of bytes that held good records
+   */
+  static off_t replayFile(const string &path,
+                          map<uint32_t, SessionState> &sessions) {
+    string data;
+    int in = ::open(path.c_str(), O_RDONLY);
+    if (in < 0) {
+      return 0;
+    }
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = ::read(in, buffer, sizeof(buffer))) > 0) {
+      data.append(buffer, got);
+    }
+    ::close(in);
+    size_t pos = 0;
+    while (data.size() - pos >= HEADER_SIZE + CHECKSUM_SIZE) {
+      uint32_t session;
+      uint16_t length;
+      memcpy(&session, data.data() + pos + 1, 4);
+      memcpy(&length, data.data() + pos + 5, 2);
+      size_t end = pos + HEADER_SIZE + length;
+      if (end + CHECKSUM_SIZE > data.size()) {
+        break;
+      }
+      uint32_t sum;
+      memcpy(&sum, data.data() + end, 4);
+      if (sum != checksum(data.data() + pos, end - pos)) {
+        break;
+      }
+      apply(sessions, data[pos], session,
+            data.substr(pos + HEADER_SIZE, length));
+      pos = end + CHECKSUM_SIZE;
+    }
+    return pos;
+  }
+
+  static bool writeAll(int out, const string &data) {
+    size_t done = 0;
+    while (done < data.size()) {
+      ssize_t wrote = ::write(out, data.data() + done, data.size() - done);
+      if (wrote < 0) {
+        return false;
+      }
+      done += wrote;
+    }
+    return true;
+  }
+
+  // makes renames and new files in the journal's directory durable
+  void syncDirectory() {
+    size_t slash = journalPath.rfind('/');
+    string dir = slash == string::npos ? "." : journalPath.substr(0, slash + 1);
+    int dirFd = ::open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+      ::fsync(dirFd);
+      ::close(dirFd);
+    }
+  }
+
+  string snapshotPath() const { return journalPath + ".snap"; }
+  string oldJournalPath() const { return journalPath + ".old"; }
+
+  /*
+   * function: compact
+   * description: moves the journal aside, folds it into a new
+   *   snapshot and removes it. Runs on the compactor thread; the
+   *   flusher only waits for the move.
+   *
+   * return:  nothing
+   */
+  void compact() {
+    // a journal left aside by a failed compaction is folded in first,
+    // the current one waits for the next round
+    if (::access(oldJournalPath().c_str(), F_OK) != 0) {
+      lock_guard<mutex> files(fileLock);
+      ::close(fd);
+      ::rename(journalPath.c_str(), oldJournalPath().c_str());
+      fd = ::open(journalPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,
+                  0644);
+      journalSize = 0;
+      syncDirectory();
+    }
+
+    map<uint32_t, SessionState> sessions;
+    replayFile(snapshotPath(), sessions);
+    replayFile(oldJournalPath(), sessions);
+    string snapshot;
+    for (auto &entry : sessions) {
+      const SessionState &state = entry.second;
+      if (state.centralLetter != 0) {
+        encode(snapshot, SET_LETTERS, entry.first,
+               state.centralLetter + state.allowedLetters);
+      }
+      for (auto &word : state.words) {
+        encode(snapshot, FOUND_WORD, entry.first, word);
+      }
+    }
+    string temp = snapshotPath() + ".tmp";
+    int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+      return;
+    }
+    bool ok = writeAll(out, snapshot) && ::fsync(out) == 0;
+    ::close(out);
+    if (ok && ::rename(temp.c_str(), snapshotPath().c_str()) == 0) {
+      {
+        lock_guard<mutex> files(fileLock);
+        snapshotSize = snapshot.size();
+      }
+      syncDirectory();
+      ::unlink(oldJournalPath().c_str());
+    }
+  }
+
+  /*
+   * function: flushLoop
+   * description: the flusher thread. Sleeps until a record is queued,
+   *   gives others GROUP_COMMIT_MS to join it, then writes and fsyncs
+   *   everything waiting in one go and wakes anyone in sync(). A
+   *   failed write is cut off the file again and fails the journal.
+   *   Asks for a compaction when the journal is big enough.
+   *
+   * return:  nothing
+   */
+  void flushLoop() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+      wake.wait(guard, [this] { return stopping || !pending.empty(); });
+      wake.wait_for(guard, chrono::milliseconds(GROUP_COMMIT_MS), [this] {
+        return stopping || pending.size() >= GROUP_COMMIT_BYTES;
+      });
+      if (failed) {
+        pending.clear();
+        drained.notify_all();
+      }
+      if (pending.empty()) {
+        if (stopping) {
+          return;
+        }
+        continue;
+      }
+      writing.swap(pending);
+      uint64_t batchEnd = appended;
+      drained.notify_all();
+      guard.unlock();
+      bool ok;
+      bool full;
+      {
+        lock_guard<mutex> files(fileLock);
+        ok = writeAll(fd, writing) && ::fdatasync(fd) == 0;
+        if (ok) {
+          journalSize += writing.size();
+        } else {
+          // a partial record would stop the replay before anything
+          // written after it
+          ::ftruncate(fd, journalSize);
+        }
+        full = journalSize >= COMPACT_BYTES && journalSize >= snapshotSize;
+      }
+      // keeps its capacity for the next swap
+      writing.clear();
+      guard.lock();
+      if (ok) {
+        durable = batchEnd;
+      } else {
+        failed = true;
+      }
+      synced.notify_all();
+      if (full && !compactWanted) {
+        compactWanted = true;
+        compactWake.notify_one();
+      }
+    }
+  }
+
+  // the compactor thread, at the lowest priority so on a busy or
+  // single core machine it does not take time from the game
+  void compactLoop() {
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+    unique_lock<mutex> guard(lock);
+    while (true) {
+      compactWake.wait(guard, [this] { return stopping || compactWanted; });
+      if (stopping) {
+        return;
+      }
+      guard.unlock();
+      compact();
+      guard.lock();
+      compactWanted = false;
+    }
+  }
+
+  void append(RecordType type, uint32_t session, const string &payload) {
+    unique_lock<mutex> guard(lock);
+    size_t size = HEADER_SIZE + payload.size() + CHECKSUM_SIZE;
+    if (active && pending.size() + size > PENDING_BYTES) {
+      // the disk is behind: wait for the flusher to take the buffer
+      wake.notify_one();
+      drained.wait(guard, [this, size] {
+        return !active || failed || pending.size() + size <= PENDING_BYTES;
+      });
+    }
+    if (!active || failed) {
+      return;
+    }
+    bool first = pending.empty();
+    encode(pending, type, session, payload);
+    appended++;
+    // the first record starts the group commit timer
+    if (first || pending.size() >= GROUP_COMMIT_BYTES) {
+      wake.notify_one();
+    }
+  }
+
+public:
+  /**
+   * constructor and destructor
+   */
+  SessionJournal()
+      : fd(-1), journalSize(0), snapshotSize(0), appended(0), durable(0),
+        stopping(false), active(false), failed(false), compactWanted(false) {
+    pending.reserve(PENDING_BYTES);
+    writing.reserve(PENDING_BYTES);
+  }
+  ~SessionJournal() { close(); }
+
+  /*
+   * function: open
+   * description:  rebuilds every session recorded at path (plus its
+   *   .snap and .old files), then starts journaling to it.
+   *
+   * parameter: string path - journal file
+   *            map sessions - filled with the recovered sessions
+   *
+   * return:  indicates success/failure (journal could not be opened)
+   */
+  bool open(const string &path, map<uint32_t, SessionState> &sessions) {
+    close();
+    journalPath = path;
+    snapshotSize = replayFile(snapshotPath(), sessions);
+    replayFile(oldJournalPath(), sessions);
+    journalSize = replayFile(journalPath, sessions);
+    fd = ::open(journalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+      return false;
+    }
+    // drop a record cut short by a crash
+    if (::ftruncate(fd, journalSize) != 0) {
+      ::close(fd);
+      fd = -1;
+      return false;
+    }
+    stopping = false;
+    active = true;
+    failed = false;
+    compactWanted = false;
+    flusher = thread(&SessionJournal::flushLoop, this);
+    compactor = thread(&SessionJournal::compactLoop, this);
+    return true;
+  }
+
+  /*
+   * function: logLetters / logWord
+   * description:  record a new letter set (which starts the session
+   *   over) or a newly found word. Returns once the record is queued;
+   *   it reaches the disk with the next group commit. Dropped once
+   *   the journal has failed.
+   *
+   * return:  nothing
+   */
+  void logLetters(uint32_t session, char centralLetter,
+                  const string &allowedLetters) {
+    append(SET_LETTERS, session, centralLetter + allowedLetters);
+  }
+
+  void logWord(uint32_t session, const string &word) {
+    append(FOUND_WORD, session, word);
+  }
+
+  /*
+   * function: sync
+   * description:  waits until every record logged so far is on disk.
+   *
+   * return:  indicates success/failure (a write or fsync failed, or
+   *   the journal is closed, and some of the records are lost)
+   */
+  bool sync() {
+    unique_lock<mutex> guard(lock);
+    uint64_t target = appended;
+    wake.notify_one();
+    synced.wait(guard, [this, target] {
+      return durable >= target || failed || !active;
+    });
+    return durable >= target;
+  }
+
+  /*
+   * function: close
+   * description:  writes out what is left and stops the background
+   *   thread.
+   *
+   * return:  nothing
+   */
+  void close() {
+    {
+      lock_guard<mutex> guard(lock);
+      if (!active) {
+        return;
+      }
+      stopping = true;
+      wake.notify_one();
+      compactWake.notify_one();
+    }
+    flusher.join();
+    compactor.join();
+    {
+      lock_guard<mutex> guard(lock);
+      active = false;
+    }
+    synced.notify_all();
+    drained.notify_all();
+    ::close(fd);
+    fd = -1;
+  }
+};
+
+#endif
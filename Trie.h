@@ -2,6 +2,8 @@
 #ifndef _MY_TRIE_H
 #define _MY_TRIE_H
 
+#include "TrieStats.h"
+#include "WordReader.h"
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -10,6 +12,9 @@ using namespace std;
 
 class Trie {
 
+  // FrozenTrie copies the finished node structure into its own layout
+  friend class FrozenTrie;
+
 protected:
   // private/protected stuff goes here!
   //  - protected allows this class to be inherited
@@ -37,7 +42,7 @@ protected:
   //   private helper functions
   //   etc.
 
-  int letterCount(TrieNode *currNode) {
+  int letterCount(TrieNode *currNode) const {
     int count = 0;
     for (int i = 0; i < 26; i++) {
       if (currNode->letters.at(i) != nullptr) {
@@ -107,6 +112,89 @@ protected:
     }
     delete currentNode;
   }
+  void statsHelper(TrieNode *currNode, int depth, TrieStats &stats) const {
+    int children = letterCount(currNode);
+    stats.addNode(depth, children, currNode->isWord);
+    stats.bytes += sizeof(TrieNode) +
+                   currNode->letters.capacity() * sizeof(TrieNode *);
+    stats.emptySlots += currNode->letters.size() - children;
+    for (int i = 0; i < 26; i++) {
+      if (currNode->letters[i] != nullptr) {
+        statsHelper(currNode->letters[i], depth + 1, stats);
+      }
+    }
+  }
+
+  // state kept between words while bulk loading: the last word added
+  // and the nodes along its path (path[i] is the node reached after i
+  // letters), so the next word can start below the shared prefix.
+  // fastPath stays on while the load started from an empty trie and
+  // the words keep coming in sorted order.
+  struct BulkLoad {
+    string lastWord;
+    vector<TrieNode *> path;
+    bool fastPath;
+  };
+
+  /*
+   * function: startBulkLoad
+   * description: sets up the state for a series of bulkInsert calls.
+   *
+   * return:  nothing
+   */
+  void startBulkLoad(BulkLoad &load) {
+    load.lastWord.clear();
+    load.path.assign(1, root);
+    load.fastPath = (wordCounter == 0);
+  }
+
+  /*
+   * function: bulkInsert
+   * description: inserts a lowercase word, reusing the path of the
+   *    previous word for the prefix they share. While the input is
+   *    sorted and the trie started empty, nothing past the shared
+   *    prefix can exist yet, so those nodes are created without
+   *    looking, and a duplicate can only be the previous word.
+   *    Otherwise each step checks for an existing node, as insert
+   *    does.
+   *
+   * return:  indicates success/failure (word already there)
+   */
+  bool bulkInsert(BulkLoad &load, const char *word, size_t length) {
+    const string &last = load.lastWord;
+    size_t common = 0;
+    size_t limit = length < last.size() ? length : last.size();
+    while (common < limit && word[common] == last[common]) {
+      common++;
+    }
+    if (common == length && common == last.size() && !last.empty()) {
+      // Same as the previous word
+      return false;
+    }
+    // A word that is a prefix of, or sorts before, the previous word
+    // means the input is not sorted
+    if (common == length || (common < last.size() && word[common] < last[common])) {
+      load.fastPath = false;
+    }
+    load.path.resize(common + 1);
+    TrieNode *currentNode = load.path[common];
+    for (size_t i = common; i < length; i++) {
+      int index = word[i] - 'a';
+      if (load.fastPath || currentNode->letters[index] == nullptr) {
+        currentNode->letters[index] = new TrieNode();
+      }
+      currentNode = currentNode->letters[index];
+      load.path.push_back(currentNode);
+    }
+    load.lastWord.assign(word, length);
+    if (currentNode->isWord) {
+      return false;
+    }
+    currentNode->isWord = true;
+    wordCounter++;
+    return true;
+  }
+
   /*
    * function: isWord
    * description:  loops through every character in the word
@@ -117,10 +205,10 @@ protected:
    *
    * return:  indicates success/failure
    */
-  bool isValidWord(string word) {
+  bool isValidWord(const string &word) const {
     // Checks if word only contain letters
-    for (int i = 0; i < word.length(); i++) {
-      if (!isalpha(word.at(i))) {
+    for (auto character : word) {
+      if (!isalpha((unsigned char)character)) {
         // Not a word
         return false;
       }
@@ -153,28 +241,21 @@ public:
    *   Words are separated by whitespace characters and
    *   must only contain letters.
    *
+   *   The file is read in large blocks and WordScanner splits,
+   *   checks and lowercases each block in a single pass. gzip and
+   *   zstd files are decompressed on the fly (see WordReader).
+   *   progress, if given, follows how much of the file is read.
+   *
    * return:  indicates success/failure (file not readable...)
    */
-  bool getFromFile(string filename) {
-    ifstream fileStream;
-    // cout << "Opening file: " << filename << endl;
-    fileStream.open(filename);
-    if (!fileStream.is_open()) {
-      // cout << "Could not open file " << filename << "." << endl;
-      return false;
-    }
-    // cout << "Reading words from file\n";
-    string word;
-    while (fileStream >> word) {
-      // If the word only contains letters
-      if (isValidWord(word)) {
-        // Calls insert function to put in Trie
-        lowerString(word);
-        insert(word);
-      }
-    }
-    fileStream.close();
-    return true;
+  bool getFromFile(string filename, ReadProgress *progress = nullptr) {
+    BulkLoad load;
+    startBulkLoad(load);
+    return WordReader::readWords(filename, [this, &load](const char *word,
+                                                         size_t length) {
+      // Sorted files take the fast path in bulkInsert
+      bulkInsert(load, word, length);
+    }, progress);
   }
 
   /*
@@ -191,11 +272,7 @@ public:
     if (!isValidWord(word)) {
       return false;
     }
-    // Checking if the word exist in Trie already
-    if (search(word)) {
-      return false;
-    }
-    // Insert into the Trie
+    // Insert into the Trie, an existing word only walks existing nodes
     TrieNode *currentNode = root;
     for (auto character : word) {
       // Index where the character is going to be inserted in TrieNode vector
@@ -208,6 +285,10 @@ public:
       // For example word "apple", "a" -> "ap"
       currentNode = currentNode->letters[index];
     }
+    // Checking if the word exist in Trie already
+    if (currentNode->isWord) {
+      return false;
+    }
     // Update the counter after the word has been inserted
     // and mark it as a word
     currentNode->isWord = true;
@@ -215,6 +296,53 @@ public:
     return true;
   }
 
+  /*
+   * function: insertSorted
+   * description:  inserts every word of the vector into the trie in
+   *   one left to right pass. Meant for word lists that are already
+   *   in ascending order: each word starts from the prefix it shares
+   *   with the one before it and duplicates are skipped. Unsorted
+   *   input still works, only without the fast path.
+   *
+   *   words with characters other than lowercase letters are skipped
+   *
+   *   progress, if given, counts the words done, and the insert
+   *   stops early once it is cancelled.
+   *
+   * return:  the number of words inserted
+   */
+  int insertSorted(const vector<string> &sortedWords,
+                   ReadProgress *progress = nullptr) {
+    BulkLoad load;
+    startBulkLoad(load);
+    int inserted = 0;
+    if (progress != nullptr) {
+      progress->done = 0;
+      progress->total = sortedWords.size();
+    }
+    for (size_t i = 0; i < sortedWords.size(); i++) {
+      if (progress != nullptr && i % 4096 == 0) {
+        if (progress->cancelled) {
+          break;
+        }
+        progress->done = i;
+      }
+      const string &word = sortedWords[i];
+      bool lowercase = true;
+      for (auto character : word) {
+        if (character < 'a' || character > 'z') {
+          lowercase = false;
+          break;
+        }
+      }
+      if (lowercase && !word.empty() &&
+          bulkInsert(load, word.data(), word.length())) {
+        inserted++;
+      }
+    }
+    return inserted;
+  }
+
   /*
    * function: search
    * description:  determines if the word given by the parameter
@@ -333,6 +461,19 @@ public:
    */
   int wordCount() const { return wordCounter; }
 
+  /*
+   * function: stats
+   * description:  walks the whole trie and counts its nodes, bytes,
+   *   empty child slots, fan-out and depth (see TrieStats).
+   *
+   * return:  the stats
+   */
+  TrieStats stats() const {
+    TrieStats trieStats;
+    statsHelper(root, 0, trieStats);
+    return trieStats;
+  }
+
   /*
    * function: words
    * description:  build a vector of all words in the dictionary and return that
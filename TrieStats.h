@@ -0,0 +1,131 @@
+
+#ifndef _MY_TRIE_STATS_H
+#define _MY_TRIE_STATS_H
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct TrieStats {
+
+  // Size and shape of one trie, filled in by the stats() methods.
+  // Depth is counted in nodes from the root, so for a radix trie it
+  // is the number of steps a search takes, not the word length.
+
+  long nodes;
+  long words;
+  long bytes;      // nodes plus their child arrays, no allocator overhead
+  long emptySlots; // child slots allocated but holding no child
+  int maxDepth;
+  long wordDepthSum;
+  vector<long> fanout; // fanout[k] = nodes with k children
+  vector<long> depths; // depths[d] = nodes at depth d
+
+  TrieStats()
+      : nodes(0), words(0), bytes(0), emptySlots(0), maxDepth(0),
+        wordDepthSum(0), fanout(27, 0) {}
+
+  /*
+   * function: addNode
+   * description: counts one node at the given depth with the given
+   *   number of children.
+   *
+   * return:  nothing
+   */
+  void addNode(int depth, int children, bool isWord) {
+    nodes++;
+    fanout[children < 26 ? children : 26]++;
+    if ((int)depths.size() <= depth) {
+      depths.resize(depth + 1, 0);
+    }
+    depths[depth]++;
+    if (depth > maxDepth) {
+      maxDepth = depth;
+    }
+    if (isWord) {
+      words++;
+      wordDepthSum += depth;
+    }
+  }
+
+  /*
+   * function: walk
+   * description: counts every node below node, for the read-only
+   *   tries that share the root/child/isWord/childCount calls.
+   *
+   * return:  nothing
+   */
+  template <typename Dict> void walk(const Dict &dict, uint32_t node, int depth) {
+    addNode(depth, dict.childCount(node), dict.isWord(node));
+    for (int letter = 0; letter < 26; letter++) {
+      uint32_t next = dict.child(node, letter);
+      if (next != Dict::npos) {
+        walk(dict, next, depth + 1);
+      }
+    }
+  }
+
+  double averageDepth() const {
+    return words == 0 ? 0 : (double)wordDepthSum / words;
+  }
+
+  /*
+   * function: print
+   * description: writes the stats under the given name, either as a
+   *   short table for people or as name.key=value lines for scripts.
+   *
+   * return:  nothing
+   */
+  void print(ostream &out, string name, bool machine) const {
+    if (machine) {
+      out << name << ".nodes=" << nodes << "\n";
+      out << name << ".words=" << words << "\n";
+      out << name << ".bytes=" << bytes << "\n";
+      out << name << ".empty_slots=" << emptySlots << "\n";
+      out << name << ".avg_depth=" << averageDepth() << "\n";
+      out << name << ".max_depth=" << maxDepth << "\n";
+      out << name << ".fanout=";
+      printList(out, fanout);
+      out << name << ".depths=";
+      printList(out, depths);
+      return;
+    }
+    out << name << ": " << nodes << " nodes, " << words << " words, "
+        << bytes << " bytes";
+    if (nodes > 0) {
+      out << " (" << bytes / nodes << " per node)";
+    }
+    out << "\n";
+    out << "  empty child slots: " << emptySlots << "\n";
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << "  word depth: average " << fixed << setprecision(2)
+        << averageDepth() << ", max node depth " << maxDepth << "\n";
+    out.flags(flags);
+    out.precision(precision);
+    out << "  fan-out:";
+    for (size_t k = 0; k < fanout.size(); k++) {
+      if (fanout[k] > 0) {
+        out << " " << k << ":" << fanout[k];
+      }
+    }
+    out << "\n";
+    out << "  nodes per depth:";
+    for (size_t d = 0; d < depths.size(); d++) {
+      out << " " << d << ":" << depths[d];
+    }
+    out << "\n";
+  }
+
+  static void printList(ostream &out, const vector<long> &values) {
+    for (size_t i = 0; i < values.size(); i++) {
+      out << (i == 0 ? "" : ",") << values[i];
+    }
+    out << "\n";
+  }
+};
+
+#endif
@@ -0,0 +1,396 @@
+
+#ifndef _MY_WORD_READER_H
+#define _MY_WORD_READER_H
+
+#include "WordScanner.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+class ChunkQueue {
+
+  // A bounded queue of text chunks between one producer and one
+  // consumer thread. Used buffers are handed back so at most
+  // `capacity` chunks are ever allocated.
+
+protected:
+  //   data members
+  deque<vector<char>> full;
+  deque<vector<char>> empty;
+  size_t capacity;
+  size_t allocated;
+  bool closed;
+  mutex lock;
+  condition_variable changed;
+
+public:
+  ChunkQueue(size_t c) : capacity(c), allocated(0), closed(false) {}
+
+  /*
+   * function: getBuffer
+   * description: returns a free buffer to fill, waiting while all of
+   *   them are in the queue.
+   *
+   * return:  the buffer (empty vector if the queue was closed)
+   */
+  vector<char> getBuffer() {
+    unique_lock<mutex> guard(lock);
+    if (empty.empty() && allocated < capacity) {
+      allocated++;
+      return vector<char>();
+    }
+    changed.wait(guard, [this] { return !empty.empty() || closed; });
+    if (empty.empty()) {
+      return vector<char>();
+    }
+    vector<char> buffer = move(empty.front());
+    empty.pop_front();
+    return buffer;
+  }
+
+  void push(vector<char> chunk) {
+    lock_guard<mutex> guard(lock);
+    full.push_back(move(chunk));
+    changed.notify_all();
+  }
+
+  /*
+   * function: pop
+   * description: waits for the next chunk.
+   *
+   * return:  false once the queue is closed and drained
+   */
+  bool pop(vector<char> &chunk) {
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this] { return !full.empty() || closed; });
+    if (full.empty()) {
+      return false;
+    }
+    chunk = move(full.front());
+    full.pop_front();
+    return true;
+  }
+
+  void giveBack(vector<char> chunk) {
+    lock_guard<mutex> guard(lock);
+    empty.push_back(move(chunk));
+    changed.notify_all();
+  }
+
+  void close() {
+    lock_guard<mutex> guard(lock);
+    closed = true;
+    changed.notify_all();
+  }
+};
+
+struct ReadProgress {
+
+  // How far readWords has got through a file, in bytes of the file
+  // itself (compressed bytes for a compressed file), or
+  // Trie::insertSorted through its words. Safe to read
+  // from another thread while the file is read. Setting cancelled
+  // from another thread stops the read at the next block, and
+  // readWords then fails.
+
+  atomic<long> done;
+  atomic<long> total;
+  atomic<bool> cancelled;
+
+  ReadProgress() : done(0), total(0), cancelled(false) {}
+
+  int percent() const {
+    long size = total.load();
+    return size > 0 ? (int)(done.load() * 100 / size) : 0;
+  }
+};
+
+class WordReader {
+
+  // Reads the words of a dictionary file through WordScanner.
+  //
+  // Plain text is read in blocks on the calling thread. A gzip or
+  // zstd file (found by its magic bytes, not its name) is
+  // decompressed on a second thread into a few fixed size chunks,
+  // while the calling thread splits and inserts the words of the
+  // chunks already done. Nothing is written to disk, and memory stays
+  // at CHUNKS * CHUNK_SIZE whatever the file size. Support for each
+  // format is built in when the library was found (HAVE_ZLIB,
+  // HAVE_ZSTD).
+
+protected:
+  enum Format { PLAIN, GZIP, ZSTD };
+  static const size_t CHUNK_SIZE = 1 << 18;
+  static const size_t CHUNKS = 4;
+  static const size_t READ_SIZE = 1 << 16;
+
+  static bool cancelled(ReadProgress *progress) {
+    return progress != nullptr && progress->cancelled;
+  }
+
+  // reads the next block of the file, counting it in progress; a
+  // cancelled read sees the end of the file
+  static size_t readBlock(ifstream &fileStream, vector<char> &buffer,
+                          ReadProgress *progress) {
+    if (cancelled(progress)) {
+      return 0;
+    }
+    fileStream.read(buffer.data(), buffer.size());
+    size_t length = fileStream.gcount();
+    if (progress != nullptr) {
+      progress->done += length;
+    }
+    return length;
+  }
+
+  static Format detect(const unsigned char *magic, size_t length) {
+    if (length >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+      return GZIP;
+    }
+    if (length >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 &&
+        magic[2] == 0x2f && magic[3] == 0xfd) {
+      return ZSTD;
+    }
+    return PLAIN;
+  }
+
+#ifdef HAVE_ZLIB
+  /*
+   * function: inflateFile
+   * description: producer for gzip files. Handles files made of
+   *   several gzip members one after another.
+   *
+   * return:  indicates success/failure (corrupt or cut off data)
+   */
+  static bool inflateFile(ifstream &fileStream, ChunkQueue &queue,
+                          ReadProgress *progress) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // 15 + 32: largest window, gzip or zlib header
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+      return false;
+    }
+    vector<char> input(READ_SIZE);
+    int status = Z_OK;
+    bool ok = true;
+    vector<char> chunk = queue.getBuffer();
+    chunk.resize(CHUNK_SIZE);
+    stream.next_out = (Bytef *)chunk.data();
+    stream.avail_out = CHUNK_SIZE;
+    while (ok) {
+      if (stream.avail_in == 0) {
+        size_t length = readBlock(fileStream, input, progress);
+        if (length == 0) {
+          // input ended, it is fine only at the end of a member
+          ok = (status == Z_STREAM_END);
+          break;
+        }
+        stream.next_in = (Bytef *)input.data();
+        stream.avail_in = length;
+      }
+      if (status == Z_STREAM_END) {
+        // zero bytes after a member are padding (gzip -d skips them
+        // too); read on until another member starts or input ends
+        while (stream.avail_in > 0 && *stream.next_in == 0) {
+          stream.next_in++;
+          stream.avail_in--;
+        }
+        if (stream.avail_in == 0) {
+          continue;
+        }
+        // another member follows
+        inflateReset(&stream);
+      }
+      status = inflate(&stream, Z_NO_FLUSH);
+      if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+        ok = false;
+      }
+      if (stream.avail_out == 0) {
+        queue.push(move(chunk));
+        chunk = queue.getBuffer();
+        chunk.resize(CHUNK_SIZE);
+        stream.next_out = (Bytef *)chunk.data();
+        stream.avail_out = CHUNK_SIZE;
+      }
+    }
+    chunk.resize(CHUNK_SIZE - stream.avail_out);
+    queue.push(move(chunk));
+    inflateEnd(&stream);
+    return ok;
+  }
+#endif
+
+#ifdef HAVE_ZSTD
+  /*
+   * function: zstdFile
+   * description: producer for zstd files.
+   *
+   * return:  indicates success/failure (corrupt or cut off data)
+   */
+  static bool zstdFile(ifstream &fileStream, ChunkQueue &queue,
+                       ReadProgress *progress) {
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    if (stream == nullptr) {
+      return false;
+    }
+    ZSTD_initDStream(stream);
+    vector<char> input(READ_SIZE);
+    size_t status = 0;
+    bool ok = true;
+    vector<char> chunk = queue.getBuffer();
+    chunk.resize(CHUNK_SIZE);
+    ZSTD_outBuffer out = {chunk.data(), CHUNK_SIZE, 0};
+    while (ok) {
+      size_t length = readBlock(fileStream, input, progress);
+      if (length == 0) {
+        // status is 0 when the last frame was complete
+        ok = (status == 0);
+        break;
+      }
+      ZSTD_inBuffer in = {input.data(), length, 0};
+      // keep going after the input is used up while the output fills,
+      // there may be more waiting inside the decoder
+      bool outputFull = false;
+      while (ok && (in.pos < in.size || outputFull)) {
+        status = ZSTD_decompressStream(stream, &out, &in);
+        if (ZSTD_isError(status)) {
+          ok = false;
+        }
+        outputFull = (out.pos == out.size);
+        if (outputFull) {
+          queue.push(move(chunk));
+          chunk = queue.getBuffer();
+          chunk.resize(CHUNK_SIZE);
+          out.dst = chunk.data();
+          out.pos = 0;
+        }
+      }
+    }
+    chunk.resize(out.pos);
+    queue.push(move(chunk));
+    ZSTD_freeDStream(stream);
+    return ok;
+  }
+#endif
+
+  /*
+   * function: readCompressed
+   * description: runs the decompressing producer on its own thread
+   *   and scans its chunks here as they arrive.
+   *
+   * return:  indicates success/failure
+   */
+  template <typename Emit>
+  static bool readCompressed(ifstream &fileStream, Format format, Emit &emit,
+                             ReadProgress *progress) {
+    ChunkQueue queue(CHUNKS);
+    bool produced = false;
+    thread producer([&]() {
+#ifdef HAVE_ZLIB
+      if (format == GZIP) {
+        produced = inflateFile(fileStream, queue, progress);
+      }
+#endif
+#ifdef HAVE_ZSTD
+      if (format == ZSTD) {
+        produced = zstdFile(fileStream, queue, progress);
+      }
+#endif
+      queue.close();
+    });
+    WordScanner scanner;
+    vector<char> chunk;
+    while (queue.pop(chunk)) {
+      scanner.scan(chunk.data(), chunk.size(), emit);
+      queue.giveBack(move(chunk));
+    }
+    scanner.finish(emit);
+    producer.join();
+    return produced;
+  }
+
+public:
+  /*
+   * function: supports
+   * description: checks if this build can read files compressed with
+   *   the format ("gzip" or "zstd").
+   *
+   * return:  indicates success/failure
+   */
+  static bool supports(const string &format) {
+#ifdef HAVE_ZLIB
+    if (format == "gzip") {
+      return true;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (format == "zstd") {
+      return true;
+    }
+#endif
+    return false;
+  }
+
+  /*
+   * function: readWords
+   * description: calls emit(const char *word, size_t length) for every
+   *   lowercased word of the file that has only letters, in file
+   *   order. If progress is given, it is kept up to date as the file
+   *   is read.
+   *
+   * return:  indicates success/failure (file not readable, compressed
+   *   in a format this build cannot read, corrupt, or cancelled)
+   */
+  template <typename Emit>
+  static bool readWords(const string &filename, Emit emit,
+                        ReadProgress *progress = nullptr) {
+    ifstream fileStream(filename, ios::binary);
+    if (!fileStream.is_open()) {
+      return false;
+    }
+    if (progress != nullptr) {
+      fileStream.seekg(0, ios::end);
+      progress->done = 0;
+      progress->total = (long)fileStream.tellg();
+      fileStream.seekg(0);
+    }
+    vector<char> buffer(READ_SIZE);
+    size_t length = readBlock(fileStream, buffer, progress);
+    Format format = detect((const unsigned char *)buffer.data(), length);
+    if (format != PLAIN) {
+      if (!supports(format == GZIP ? "gzip" : "zstd")) {
+        return false;
+      }
+      fileStream.clear();
+      fileStream.seekg(0);
+      if (progress != nullptr) {
+        progress->done = 0;
+      }
+      return readCompressed(fileStream, format, emit, progress) &&
+             !cancelled(progress);
+    }
+    WordScanner scanner;
+    while (length > 0) {
+      scanner.scan(buffer.data(), length, emit);
+      length = readBlock(fileStream, buffer, progress);
+    }
+    scanner.finish(emit);
+    return !cancelled(progress);
+  }
+};
+
+#endif
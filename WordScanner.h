@@ -0,0 +1,241 @@
+
+#ifndef _MY_WORD_SCANNER_H
+#define _MY_WORD_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+using namespace std;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WORD_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+class WordScanner {
+
+  // Splits raw dictionary text into words in one pass. Every byte is
+  // classified (letter / whitespace / other) and folded to lowercase
+  // 32 bytes at a time, using AVX2 or SSE2 when the CPU has them and
+  // plain C++ otherwise. The whitespace bits of each block give the
+  // word boundaries, and a word is only kept if none of its bytes
+  // were "other". Same rules as reading with >> and checking isalpha
+  // in the "C" locale.
+  //
+  // Text can be fed in chunks; a word cut at the end of a chunk is
+  // carried over to the next one.
+
+protected:
+  //   typedefs
+  //   block kernel: lowercases up to 32 bytes in place and sets one
+  //   bit per byte in space (whitespace) and bad (not a letter)
+  typedef void (*BlockKernel)(char *data, uint32_t &space, uint32_t &bad);
+  //   data members
+  string pending;
+  bool inWord;
+  bool wordBad;
+
+  /*
+   * function: scalarBlock
+   * description: classifies and lowercases length bytes (at most 32)
+   *   one at a time. Used for the tail of a chunk and on CPUs
+   *   without vector support.
+   *
+   * return:  nothing
+   */
+  static void scalarBlock(char *data, size_t length, uint32_t &space,
+                          uint32_t &bad) {
+    space = 0;
+    bad = 0;
+    for (size_t i = 0; i < length; i++) {
+      unsigned char c = data[i];
+      if ((unsigned char)(c - 'A') < 26) {
+        c |= 0x20;
+        data[i] = c;
+      }
+      bool isSpace = c == ' ' || (unsigned char)(c - '\t') < 5;
+      bool isLetter = (unsigned char)(c - 'a') < 26;
+      space |= (uint32_t)isSpace << i;
+      bad |= (uint32_t)(!isSpace && !isLetter) << i;
+    }
+  }
+
+  static void scalarKernel(char *data, uint32_t &space, uint32_t &bad) {
+    scalarBlock(data, 32, space, bad);
+  }
+
+#ifdef WORD_SCANNER_X86
+  // The range checks below shift each byte so the wanted range lands
+  // at the bottom of the signed char range, then do one signed
+  // compare: 'A'..'Z' + 63 -> -128..-103, 'a'..'z' + 31 -> -128..-103,
+  // '\t'..'\r' + 119 -> -128..-124.
+  __attribute__((target("sse2"))) static void sse2Kernel(char *data,
+                                                          uint32_t &space,
+                                                          uint32_t &bad) {
+    space = 0;
+    bad = 0;
+    for (int half = 0; half < 2; half++) {
+      __m128i *block = (__m128i *)(data + 16 * half);
+      __m128i x = _mm_loadu_si128(block);
+      __m128i upper = _mm_cmplt_epi8(_mm_add_epi8(x, _mm_set1_epi8(63)),
+                                     _mm_set1_epi8(-102));
+      __m128i y = _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+      __m128i letter = _mm_cmplt_epi8(_mm_add_epi8(y, _mm_set1_epi8(31)),
+                                      _mm_set1_epi8(-102));
+      __m128i white = _mm_or_si128(
+          _mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+          _mm_cmplt_epi8(_mm_add_epi8(x, _mm_set1_epi8(119)),
+                         _mm_set1_epi8(-123)));
+      _mm_storeu_si128(block, y);
+      uint32_t whiteBits = (uint32_t)_mm_movemask_epi8(white);
+      uint32_t okBits = (uint32_t)_mm_movemask_epi8(_mm_or_si128(white, letter));
+      space |= whiteBits << (16 * half);
+      bad |= (~okBits & 0xFFFF) << (16 * half);
+    }
+  }
+
+  __attribute__((target("avx2"))) static void avx2Kernel(char *data,
+                                                          uint32_t &space,
+                                                          uint32_t &bad) {
+    __m256i *block = (__m256i *)data;
+    __m256i x = _mm256_loadu_si256(block);
+    __m256i upper = _mm256_cmpgt_epi8(
+        _mm256_set1_epi8(-102), _mm256_add_epi8(x, _mm256_set1_epi8(63)));
+    __m256i y =
+        _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+    __m256i letter = _mm256_cmpgt_epi8(
+        _mm256_set1_epi8(-102), _mm256_add_epi8(y, _mm256_set1_epi8(31)));
+    __m256i white = _mm256_or_si256(
+        _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(-123),
+                          _mm256_add_epi8(x, _mm256_set1_epi8(119))));
+    _mm256_storeu_si256(block, y);
+    space = (uint32_t)_mm256_movemask_epi8(white);
+    bad = ~(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(white, letter));
+  }
+#endif
+
+  /*
+   * function: kernel
+   * description: picks the fastest block kernel for this CPU the
+   *   first time it is called.
+   *
+   * return:  the block kernel
+   */
+  static BlockKernel kernel() {
+    static BlockKernel chosen = pickKernel();
+    return chosen;
+  }
+
+  static BlockKernel pickKernel() {
+#ifdef WORD_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return avx2Kernel;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return sse2Kernel;
+    }
+#endif
+    return scalarKernel;
+  }
+
+  /*
+   * function: endWord
+   * description: finishes the word that ends just before data + end
+   *   and hands it to emit if it only had letters.
+   *
+   * return:  nothing
+   */
+  template <typename Emit>
+  void endWord(const char *data, size_t start, size_t end, Emit &emit) {
+    if (!wordBad) {
+      if (pending.empty()) {
+        emit(data + start, end - start);
+      } else {
+        pending.append(data + start, end - start);
+        emit(pending.data(), pending.size());
+      }
+    }
+    pending.clear();
+    inWord = false;
+    wordBad = false;
+  }
+
+public:
+  /**
+   * constructor
+   */
+  WordScanner() : inWord(false), wordBad(false) {}
+
+  /*
+   * function: scan
+   * description: lowercases the chunk in place and calls
+   *   emit(const char *word, size_t length) for every word in it
+   *   made only of letters. A word running off the end of the chunk
+   *   is kept until the next scan or finish.
+   *
+   * return:  nothing
+   */
+  template <typename Emit> void scan(char *data, size_t length, Emit emit) {
+    BlockKernel fold = kernel();
+    // start of the current word in this chunk (0 if carried over)
+    size_t start = 0;
+    for (size_t base = 0; base < length; base += 32) {
+      size_t n = length - base < 32 ? length - base : 32;
+      uint32_t space, bad;
+      if (n == 32) {
+        fold(data + base, space, bad);
+      } else {
+        scalarBlock(data + base, n, space, bad);
+      }
+      // walk the whitespace bits; bytes between them are word bytes
+      unsigned pos = 0;
+      while (space != 0) {
+        unsigned s = __builtin_ctz(space);
+        if (s > pos) {
+          if (!inWord) {
+            inWord = true;
+            start = base + pos;
+          }
+          uint32_t between = ((1u << s) - 1) & ~((1u << pos) - 1);
+          wordBad = wordBad || (bad & between) != 0;
+        }
+        if (inWord) {
+          endWord(data, start, base + s, emit);
+        }
+        space &= space - 1;
+        pos = s + 1;
+      }
+      if (pos < n) {
+        if (!inWord) {
+          inWord = true;
+          start = base + pos;
+        }
+        wordBad = wordBad || (bad >> pos) != 0;
+      }
+    }
+    // keep the unfinished word for the next chunk
+    if (inWord && !wordBad) {
+      pending.append(data + start, length - start);
+    }
+  }
+
+  /*
+   * function: finish
+   * description: hands over the last word if the text did not end
+   *   with whitespace, and resets the scanner.
+   *
+   * return:  nothing
+   */
+  template <typename Emit> void finish(Emit emit) {
+    if (inWord && !wordBad) {
+      emit(pending.data(), pending.size());
+    }
+    pending.clear();
+    inWord = false;
+    wordBad = false;
+  }
+};
+
+#endif
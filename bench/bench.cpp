@@ -0,0 +1,146 @@
+
+#include "../FrozenTrie.h"
+#include "../LoudsTrie.h"
+#include "../RadixTrie.h"
+#include "../SBTrie.h"
+#include "../Trie.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::string;
+using std::vector;
+
+// Compares the plain Trie (and its frozen and succinct copies) with the RadixTrie on
+// one dictionary: load time, node count, node memory, search time and
+// Spelling Bee solve time.
+//
+// usage: sbbench <dictionary file> [7letters ...]
+
+typedef std::chrono::steady_clock Clock;
+
+double msSince(Clock::time_point start){
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <typename T>
+double searchAll(const T &trie, const vector<string> &words, int &found){
+  Clock::time_point start = Clock::now();
+  found = 0;
+  for (auto &word : words){
+    found += trie.search(word);
+  }
+  return msSince(start);
+}
+
+void printRow(string name, double loadMs, size_t nodes, size_t bytes,
+              double searchMs, size_t searches){
+  cout << std::left << std::setw(12) << name << std::right << std::fixed
+       << std::setprecision(1) << std::setw(10) << loadMs << std::setw(12)
+       << nodes << std::setw(14) << bytes << std::setw(12)
+       << searchMs * 1e6 / searches << "\n";
+}
+
+int main(int argc, char** argv){
+  if (argc < 2){
+    cout << "usage: " << argv[0] << " <dictionary file> [7letters ...]\n";
+    return 1;
+  }
+  string filename = argv[1];
+
+  Clock::time_point start = Clock::now();
+  Trie trie;
+  if (!trie.getFromFile(filename)){
+    cout << "Could not open file " << filename << "\n";
+    return 1;
+  }
+  double trieLoad = msSince(start);
+
+  start = Clock::now();
+  FrozenTrie frozen(trie);
+  double frozenLoad = trieLoad + msSince(start);
+
+  start = Clock::now();
+  LoudsTrie louds(frozen);
+  double loudsLoad = frozenLoad + msSince(start);
+
+  start = Clock::now();
+  RadixTrie radix;
+  radix.getFromFile(filename);
+  double radixLoad = msSince(start);
+
+  // look every word up in a random order
+  vector<string> *words = trie.words();
+  std::shuffle(words->begin(), words->end(), std::mt19937(42));
+  int found[4];
+  double trieSearch = searchAll(trie, *words, found[0]);
+  double frozenSearch = searchAll(frozen, *words, found[1]);
+  double loudsSearch = searchAll(louds, *words, found[2]);
+  double radixSearch = searchAll(radix, *words, found[3]);
+  for (int i = 0; i < 4; i++){
+    if (found[i] != (int)words->size()){
+      cout << "search missed " << words->size() - found[i] << " words\n";
+    }
+  }
+
+  // a Trie node is a 26 pointer vector plus the word flag
+  size_t trieNodeBytes = sizeof(vector<void *>) + sizeof(void *) + 26 * sizeof(void *);
+
+  cout << trie.wordCount() << " words from " << filename << "\n\n";
+  cout << std::left << std::setw(12) << "trie" << std::right << std::setw(10)
+       << "load ms" << std::setw(12) << "nodes" << std::setw(14) << "node bytes"
+       << std::setw(12) << "ns/search" << "\n";
+  printRow("Trie", trieLoad, frozen.nodeCount(),
+           frozen.nodeCount() * trieNodeBytes, trieSearch, words->size());
+  printRow("FrozenTrie", frozenLoad, frozen.nodeCount(),
+           frozen.nodeCount() * 8, frozenSearch, words->size());
+  printRow("LoudsTrie", loudsLoad, louds.nodeCount(), louds.memoryBytes(),
+           loudsSearch, words->size());
+  printRow("RadixTrie", radixLoad, radix.nodeCount(), radix.memoryBytes(),
+           radixSearch, words->size());
+  delete words;
+
+  // solve a few puzzles with both Spelling Bee walks
+  vector<string> puzzles;
+  for (int i = 2; i < argc; i++){
+    puzzles.push_back(argv[i]);
+  }
+  if (puzzles.empty()){
+    puzzles.push_back("etaoins");
+    puzzles.push_back("rdlcumw");
+  }
+  SBTrie sbt;
+  sbt.setNewDictionary(filename);
+  // warm up, so the first puzzle is timed like the rest
+  delete sbt.sbWords(puzzles[0][0], puzzles[0]);
+  cout << "\npuzzle     words  frozen ms   radix ms\n";
+  for (auto letters : puzzles){
+    sbt.setLetters(letters);
+    string sorted = letters;
+    std::sort(sorted.begin(), sorted.end());
+
+    start = Clock::now();
+    vector<string> *frozenWords = sbt.sbWords(letters[0], sorted);
+    double frozenMs = msSince(start);
+
+    start = Clock::now();
+    vector<string> *radixWords = radix.sbWords(letters[0], sorted);
+    double radixMs = msSince(start);
+
+    cout << letters << std::setw(10) << radixWords->size() << std::setw(11)
+         << frozenMs << std::setw(11) << radixMs;
+    if (*frozenWords != *radixWords){
+      cout << "  (results differ)";
+    }
+    cout << "\n";
+    delete frozenWords;
+    delete radixWords;
+  }
+  return 0;
+}
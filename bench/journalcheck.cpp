@@ -0,0 +1,227 @@
+
+#include "../SessionJournal.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::cout;
+using std::string;
+
+// Checks that SessionJournal gets every session back after the ways
+// a game can end badly: a record cut short by a crash, a crash in the
+// middle of a compaction (journal moved aside, not yet folded in), a
+// snapshot with a journal logged after it, and a failed write.
+//
+// usage: journalcheck [directory for the test files, default /tmp]
+
+typedef std::map<uint32_t, SessionJournal::SessionState> Sessions;
+
+string base;
+int failures = 0;
+
+void check(bool ok, string what){
+  cout << (ok ? "ok    " : "FAIL  ") << what << "\n";
+  if (!ok){
+    failures++;
+  }
+}
+
+off_t fileSize(string path){
+  struct stat info;
+  return ::stat(path.c_str(), &info) == 0 ? info.st_size : -1;
+}
+
+void removeFiles(){
+  ::unlink(base.c_str());
+  ::unlink((base + ".snap").c_str());
+  ::unlink((base + ".snap.tmp").c_str());
+  ::unlink((base + ".old").c_str());
+}
+
+bool sameSessions(const Sessions &a, const Sessions &b){
+  if (a.size() != b.size()){
+    return false;
+  }
+  for (auto &entry : a){
+    auto other = b.find(entry.first);
+    if (other == b.end() ||
+        entry.second.centralLetter != other->second.centralLetter ||
+        entry.second.allowedLetters != other->second.allowedLetters ||
+        entry.second.words != other->second.words){
+      return false;
+    }
+  }
+  return true;
+}
+
+// logs to the journal and keeps what it should hold in expected
+void logLetters(SessionJournal &journal, Sessions &expected, uint32_t session,
+                char central, string allowed){
+  journal.logLetters(session, central, allowed);
+  SessionJournal::SessionState &state = expected[session];
+  state.centralLetter = central;
+  state.allowedLetters = allowed;
+  state.words.clear();
+}
+
+void logWord(SessionJournal &journal, Sessions &expected, uint32_t session,
+             string word){
+  journal.logWord(session, word);
+  expected[session].words.push_back(word);
+}
+
+// a few sessions with a few words each, numbered from first
+void logGames(SessionJournal &journal, Sessions &expected, uint32_t first,
+              uint32_t count){
+  for (uint32_t session = first; session < first + count; session++){
+    logLetters(journal, expected, session, 'a', "bcdefg");
+    for (int i = 0; i < 10; i++){
+      logWord(journal, expected, session,
+              "word" + std::to_string(session) + "x" + std::to_string(i));
+    }
+  }
+}
+
+Sessions reopen(){
+  Sessions sessions;
+  SessionJournal journal;
+  journal.open(base, sessions);
+  return sessions;
+}
+
+void tornTail(){
+  removeFiles();
+  Sessions expected;
+  {
+    SessionJournal journal;
+    Sessions sessions;
+    journal.open(base, sessions);
+    logGames(journal, expected, 0, 100);
+    journal.sync();
+  }
+  off_t whole = fileSize(base);
+  // the start of a found word record, cut off by a crash
+  FILE *file = fopen(base.c_str(), "ab");
+  fwrite("\x02\x01\x00\x00\x00\x09\x00wor", 1, 10, file);
+  fclose(file);
+
+  Sessions sessions;
+  {
+    SessionJournal journal;
+    check(journal.open(base, sessions), "torn tail: journal opens");
+    check(sameSessions(sessions, expected), "torn tail: sessions restored");
+    check(fileSize(base) == whole, "torn tail: cut back to the last record");
+    logWord(journal, expected, 1, "after");
+  }
+  check(sameSessions(reopen(), expected),
+        "torn tail: records logged after it are kept");
+}
+
+void crashMidCompaction(){
+  removeFiles();
+  Sessions expected;
+  {
+    SessionJournal journal;
+    Sessions sessions;
+    journal.open(base, sessions);
+    logGames(journal, expected, 0, 100);
+  }
+  // compaction moves the journal aside before folding it in; stop
+  // there, as a crash would
+  ::rename(base.c_str(), (base + ".old").c_str());
+  {
+    SessionJournal journal;
+    Sessions sessions;
+    journal.open(base, sessions);
+    check(sameSessions(sessions, expected),
+          "crash mid-compaction: journal moved aside is replayed");
+    logGames(journal, expected, 50, 100);
+    logWord(journal, expected, 7, "later");
+  }
+  check(sameSessions(reopen(), expected),
+        "crash mid-compaction: newer journal replays on top of it");
+}
+
+void snapshotAndJournal(){
+  removeFiles();
+  Sessions expected;
+  {
+    SessionJournal journal;
+    Sessions sessions;
+    journal.open(base, sessions);
+    // well past the size that starts a compaction
+    uint32_t session = 0;
+    for (int i = 0; i < 300 && fileSize(base + ".snap") <= 0; i++){
+      logGames(journal, expected, session, 1000);
+      session += 1000;
+      journal.sync();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    check(fileSize(base + ".snap") > 0, "snapshot: compaction wrote one");
+    // start some sessions over and add to others after the snapshot
+    logLetters(journal, expected, 3, 'z', "yxwvut");
+    logWord(journal, expected, 3, "zyxw");
+    logGames(journal, expected, session, 100);
+  }
+  check(fileSize(base) > 0, "snapshot: journal holds records after it");
+  check(sameSessions(reopen(), expected),
+        "snapshot: snapshot plus journal replay to the same sessions");
+}
+
+void failedWrite(){
+  removeFiles();
+  Sessions expected;
+  // writes past the limit fail with EFBIG instead of killing us
+  signal(SIGXFSZ, SIG_IGN);
+  struct rlimit old;
+  getrlimit(RLIMIT_FSIZE, &old);
+  struct rlimit limit = old;
+  limit.rlim_cur = 1 << 16;
+  setrlimit(RLIMIT_FSIZE, &limit);
+  {
+    SessionJournal journal;
+    Sessions sessions;
+    journal.open(base, sessions);
+    logGames(journal, expected, 0, 10);
+    check(journal.sync(), "failed write: records before the limit sync");
+    logGames(journal, expected, 10, 1000);
+    check(!journal.sync(), "failed write: sync reports the lost records");
+  }
+  setrlimit(RLIMIT_FSIZE, &old);
+  signal(SIGXFSZ, SIG_DFL);
+
+  // whatever made it to disk must be whole records, the first ten
+  // sessions among them
+  Sessions sessions;
+  SessionJournal journal;
+  off_t size = fileSize(base);
+  check(journal.open(base, sessions), "failed write: journal opens");
+  check(fileSize(base) == size, "failed write: no partial record left");
+  bool kept = true;
+  for (uint32_t session = 0; session < 10; session++){
+    kept = kept && sessions[session].words == expected[session].words;
+  }
+  check(kept, "failed write: synced sessions restored");
+}
+
+int main(int argc, char** argv){
+  string dir = argc > 1 ? argv[1] : "/tmp";
+  base = dir + "/journalcheck." + std::to_string(getpid()) + ".log";
+  tornTail();
+  crashMidCompaction();
+  snapshotAndJournal();
+  failedWrite();
+  removeFiles();
+  cout << (failures == 0 ? "all passed" : std::to_string(failures) + " failed")
+       << "\n";
+  return failures == 0 ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 
 #include "SBTrie.h"
+#include "SessionJournal.h"
 #include "Trie.h"
 
 #include <string>
@@ -12,14 +13,31 @@ using std::cout;
 using std::cin;
 using std::string;
 
-void getNewDictionary(SBTrie *sbt, string filename){
+void loadBusy(SBTrie *sbt){
+  cout << "Still loading " << sbt->loadingFile() << " ("
+       << sbt->loadProgress() << "%), try again when it is done\n";
+}
+
+void getNewDictionary(SBTrie *sbt, string filename, bool batch){
   // Command 1
-  sbt->setNewDictionary(filename);
+  if (batch){
+    if (!sbt->setNewDictionary(filename)){
+      cout << "Could not load " << filename << "\n";
+    }
+  } else if (!sbt->loadNewDictionary(filename)){
+    loadBusy(sbt);
+  }
 }
 
-void updateDictionary(SBTrie *sbt, string filename){
+void updateDictionary(SBTrie *sbt, string filename, bool batch){
   // Command 2
-  sbt->addToDictionary(filename);
+  if (batch){
+    if (!sbt->addToDictionary(filename)){
+      cout << "Could not load " << filename << "\n";
+    }
+  } else if (!sbt->loadIntoDictionary(filename)){
+    loadBusy(sbt);
+  }
 }
 
 void setupLetters(SBTrie *sbt, string letters){
@@ -47,8 +65,23 @@ void showAllWords(SBTrie *sbt){
   sbt->getAllWords();
 }
 
+void showMemory(SBTrie *sbt, bool batch){
+  // Command m
+  sbt->memoryReport(batch);
+}
+
+void showAnagrams(SBTrie *sbt, string letters){
+  // Command a
+  sbt->getAnagrams(letters);
+}
+
+void explainQuery(SBTrie *sbt){
+  // Command x
+  sbt->explainLastQuery();
+}
+
 void displayCommands(){
-  cout << "\nCommands are given by digits 1 through 9\n\n";
+  cout << "\nCommands are given by digits 1 through 9 and the letters m, a and x\n\n";
   cout << "  1 <filename> - read in a new dictionary from a file\n";
   cout << "  2 <filename> - update the existing dictionary with words from a file\n";
   cout << "  3 <7letters> - enter a new central letter and 6 other letters\n";
@@ -57,27 +90,83 @@ void displayCommands(){
   cout << "  6            - display found words and other stats\n";
   cout << "  7            - list all possible Spelling Bee words from the dictionary\n";
   cout << "  8            - display this list of commands\n";
-  cout << "  9            - quit the program\n\n";
+  cout << "  9            - quit the program\n";
+  cout << "  m            - display memory use and shape of the tries\n";
+  cout << "  a <letters>  - list all words using exactly these letters\n";
+  cout << "  x            - show how the last word search was run\n\n";
 
 }
 
 int main(int argc, char** argv){
   SBTrie *sbt = new SBTrie;
+
+  // --compact keeps the dictionary in the succinct layout
+  // --batch drops the banner and prompts, loads dictionaries before
+  //   going on to the next command, and m prints key=value lines
+  // --journal <file> saves progress to file and restores it on start
+  bool batch = false;
+  string journalFile;
+  for (int i = 1; i < argc; i++){
+    if (string(argv[i]) == "--compact"){
+      sbt->setCompactDictionary(true);
+    }
+    if (string(argv[i]) == "--batch"){
+      batch = true;
+    }
+    if (string(argv[i]) == "--journal" && i + 1 < argc){
+      journalFile = argv[++i];
+    }
+  }
+
+  SessionJournal *journal = nullptr;
+  if (!journalFile.empty()){
+    journal = new SessionJournal;
+    std::map<uint32_t, SessionJournal::SessionState> sessions;
+    if (journal->open(journalFile, sessions)){
+      if (sessions.count(0) && sessions[0].centralLetter != 0){
+        sbt->restoreSession(sessions[0]);
+        if (!batch){
+          cout << "Restored saved game from " << journalFile << "\n";
+        }
+      }
+      sbt->attachJournal(journal, 0);
+    } else {
+      cout << "Could not open journal " << journalFile << "\n";
+    }
+  }
   
-  cout << "Welcome to Spelling Bee Game\n";
+  if (!batch){
+    cout << "Welcome to Spelling Bee Game\n";
 
-  displayCommands();
+    displayCommands();
+  }
   
   bool done = false;
   string line;
   string input;
 
   do {
-    cout << "cmd> ";
+    if (!batch){
+      // commands 1 and 2 load in the background, play goes on with
+      // the old dictionary until the new one is ready
+      int progress = sbt->loadProgress();
+      if (progress >= 0){
+        cout << "cmd [loading " << progress << "%]> ";
+      } else {
+        cout << "cmd> ";
+      }
+    }
 
     // read a complete line
     std::getline(std::cin, line);
 
+    DictionaryLoader::Outcome loaded = sbt->switchDictionary(false);
+    if (loaded == DictionaryLoader::LOADED){
+      cout << "Dictionary " << sbt->loadingFile() << " is ready\n";
+    } else if (loaded == DictionaryLoader::FAILED){
+      cout << "Could not load " << sbt->loadingFile() << "\n";
+    }
+
     // now create a "stringstream" on the line just read
     std::stringstream ss(line);
 
@@ -90,12 +179,12 @@ int main(int argc, char** argv){
     
     if(command == '1'){
         ss >> input;
-        getNewDictionary(sbt, input);
+        getNewDictionary(sbt, input, batch);
     }
 
     if(command == '2'){
         ss >> input;
-        updateDictionary(sbt, input);
+        updateDictionary(sbt, input, batch);
     }
         
     if(command == '3'){
@@ -121,6 +210,19 @@ int main(int argc, char** argv){
         showAllWords(sbt);
     }
 
+    if(command == 'm'){
+        showMemory(sbt, batch);
+    }
+
+    if(command == 'a'){
+        ss >> input;
+        showAnagrams(sbt, input);
+    }
+
+    if(command == 'x'){
+        explainQuery(sbt);
+    }
+
     if(command == '8' || command == '?'){
         displayCommands();
     }
@@ -130,6 +232,9 @@ int main(int argc, char** argv){
     }
 
   } while(!done && !cin.eof());
+  // don't wait for a background load or its clean up on the way out
+  sbt->abandonLoading();
   delete sbt;
+  delete journal;
   return 0;
 }